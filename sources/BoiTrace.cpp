@@ -0,0 +1,99 @@
+/*
+** Boi, 2020
+** Trace decoder entry point
+*/
+
+#include "DMG/CPU.hpp"
+#include "DMG/MMU.hpp"
+#include "DMG/TraceBuffer.hpp"
+#include "Utils/MappedFile.hpp"
+#include "Utils/OptionParser.hpp"
+#include "Utils/TermColors.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using DMG::TraceRecord;
+
+static void printText(const TraceRecord& r)
+{
+	switch (r.kind) {
+		case TraceRecord::Instruction: {
+			u16 opcode = r.pcmem[0] == 0xCB ? 0xCB00 | r.pcmem[1] : r.pcmem[0];
+			printf(
+				FAINT "A=%02X F=%02X B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X  PC=%04X SP=%04X  z=%d n=%d h=%d c=%d  cycles=%lu" RESET "\n",
+				r.a, r.f, r.b, r.c, r.d, r.e, r.h, r.l, r.pc, r.sp,
+				!!(r.f & 0x80), !!(r.f & 0x40), !!(r.f & 0x20), !!(r.f & 0x10), (unsigned long)r.cycles
+			);
+			printf(MAGENTA "%02X" RESET " :: " BLUE "%s" RESET "\n", r.pcmem[0], DMG::CPU::mnemonic(opcode));
+			break;
+		}
+		case TraceRecord::Read:
+			printf(GREEN "READ " CYAN "[%04X]" RESET " -> " MAGENTA "%02X" RESET " (%s)\n", r.address, r.value, DMG::MMU::findRegion(r.address).name);
+			break;
+		case TraceRecord::Write:
+			printf(YELLOW "WRITE " CYAN "[%04X]" RESET " <- " MAGENTA "%02X" RESET " (%s)\n", r.address, r.value, DMG::MMU::findRegion(r.address).name);
+			break;
+	}
+}
+
+// https://github.com/robert/gameboy-doctor log format
+static void printDoctor(const TraceRecord& r)
+{
+	if (r.kind != TraceRecord::Instruction)
+		return;
+
+	printf(
+		"A:%02X F:%02X B:%02X C:%02X D:%02X E:%02X H:%02X L:%02X SP:%04X PC:%04X PCMEM:%02X,%02X,%02X,%02X\n",
+		r.a, r.f, r.b, r.c, r.d, r.e, r.h, r.l, r.sp, r.pc, r.pcmem[0], r.pcmem[1], r.pcmem[2], r.pcmem[3]
+	);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	std::string trace_filename;
+	std::string format = "text";
+
+	OptionParser opt;
+	opt.addArgument(trace_filename, "Trace file written by Boi", "TRACE");
+	opt.addOption(format, 'f', "format", "Output format: text or doctor", "FORMAT");
+	if (!opt.parse(argc, argv))
+		return EXIT_FAILURE;
+
+	void (*print)(const TraceRecord&);
+	if (format == "text")
+		print = printText;
+	else if (format == "doctor")
+		print = printDoctor;
+	else {
+		std::cerr << "Unknown format \"" << format << '"' << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	MappedFile file(trace_filename);
+	if (!file.isMapped()) {
+		std::cerr << "Unable to map contents of file \"" << trace_filename << '"' << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const auto* header = static_cast<const DMG::TraceFileHeader*>(file.data());
+	if (file.size() < sizeof(*header)
+		|| memcmp(header->magic, DMG::TraceBuffer::s_magic, sizeof(header->magic)) != 0
+		|| header->version != DMG::TraceBuffer::s_version
+		|| header->record_size != sizeof(TraceRecord)
+		|| file.size() < sizeof(*header) + header->record_count * sizeof(TraceRecord)) {
+		std::cerr << '"' << trace_filename << "\" is not a valid trace file" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const auto* records = reinterpret_cast<const TraceRecord*>(header + 1);
+	for (u64 i = 0; i < header->record_count; ++i)
+		print(records[i]);
+
+	return EXIT_SUCCESS;
+}
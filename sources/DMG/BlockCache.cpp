@@ -0,0 +1,99 @@
+/*
+** Boi, 2020
+** DMG / BlockCache.cpp
+*/
+
+#include "BlockCache.hpp"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+BlockCache::BlockCache(MMU& mmu)
+: m_mmu(mmu)
+{
+	m_mmu.setCodeObserver(this);
+}
+
+BlockCache::~BlockCache()
+{
+	clear();
+	m_mmu.setCodeObserver(nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BlockCache::Block& BlockCache::lookup(u16 pc)
+{
+	u32 bank = pc < 0x8000 ? m_mmu.romBank(pc) : 0;
+	return m_blocks[(bank << 16) | pc];
+}
+
+void BlockCache::commit(Block& block)
+{
+	block.valid = true;
+	block.executions = 0;
+	block.native = nullptr;
+	if (!isRAM(block.begin))
+		return;
+
+	for (unsigned page = block.begin >> 8; page <= ((block.end - 1) & 0xFFFF) >> 8; ++page) {
+		m_page_blocks[page].push_back(&block);
+		m_mmu.setCodePage(page, true);
+	}
+}
+
+void BlockCache::invalidate(Block& block)
+{
+	block.valid = false;
+	block.invalidations++;
+	block.native = nullptr;
+	if (!isRAM(block.begin))
+		return;
+
+	for (unsigned page = block.begin >> 8; page <= ((block.end - 1) & 0xFFFF) >> 8; ++page) {
+		auto& blocks = m_page_blocks[page];
+		blocks.erase(std::remove(blocks.begin(), blocks.end(), &block), blocks.end());
+		if (blocks.empty())
+			m_mmu.setCodePage(page, false);
+	}
+}
+
+void BlockCache::clear()
+{
+	for (unsigned page = 0; page < m_page_blocks.size(); ++page) {
+		m_page_blocks[page].clear();
+		m_mmu.setCodePage(page, false);
+	}
+	m_blocks.clear();
+}
+
+void BlockCache::dropNativeCode()
+{
+	for (auto& [key, block] : m_blocks) {
+		block.native = nullptr;
+		block.executions = 0;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BlockCache::codeWritten(u16 address)
+{
+	// Copy, invalidate() edits the page's list
+	auto blocks = m_page_blocks[address >> 8];
+	for (Block* block : blocks) {
+		// Blocks ending at FFFF have their end wrap around to 0
+		if (block->begin <= address && address <= static_cast<u16>(block->end - 1))
+			invalidate(*block);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,85 @@
+/*
+** Boi, 2020
+** DMG / BlockCache.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MMU.hpp"
+#include "Utils/Types.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+class CPU;
+
+// Cache of pre-decoded basic blocks, keyed by address and ROM bank. Blocks
+// living in RAM are invalidated when the memory they were decoded from is
+// written to.
+class BlockCache final : public CodeObserver
+{
+public:
+	struct Op
+	{
+		void (CPU::*handler)();
+		u16 operand;
+		u16 next_pc;
+		u8 cycles;
+		u8 op_code; // Index in the superinstruction table when fused
+		bool prefixed;
+		bool fused = false;
+	};
+
+	using NativeCode = void (*)(CPU&);
+
+	struct Block
+	{
+		u16 begin = 0;
+		u16 end = 0;
+		u32 cycles = 0;
+		bool valid = false;
+		// Side-effect-free polling loop branching back to its own start
+		bool idle_loop = false;
+		// Single operation stopping at a breakpoint, never recompiled
+		bool breakpoint = false;
+		std::vector<Op> ops;
+
+		u32 executions = 0;
+		u32 invalidations = 0;
+		NativeCode native = nullptr;
+	};
+
+	static constexpr size_t s_max_block_length = 64;
+
+public:
+	explicit BlockCache(MMU&);
+	~BlockCache();
+
+	// Returns the slot for the block starting at `pc`. Its contents must be
+	// decoded and committed if it is not valid.
+	Block& lookup(u16 pc);
+	void commit(Block&);
+
+	void invalidate(Block&);
+	void clear();
+	void dropNativeCode();
+
+	void codeWritten(u16 address) override;
+
+private:
+	static bool isRAM(u16 address) { return address >= 0x8000; }
+
+	MMU& m_mmu;
+	std::unordered_map<u32, Block> m_blocks;
+	std::array<std::vector<Block*>, 0x100> m_page_blocks;
+};
+
+}
@@ -6,7 +6,9 @@
 #include "CPU.hpp"
 #include "Utils/Assertions.hpp"
 #include "Utils/TermColors.hpp"
+#include "Utils/Trace.hpp"
 
+#include <algorithm>
 #include <cstdio>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,14 +20,17 @@ namespace DMG
 
 CPU::CPU(MMU& mmu)
 : m_mmu(mmu)
+, m_block_cache(mmu)
+, m_handlers(s_handlers)
 {
-	fillInstructionsMap();
-
 	setAF(0x01B0);
 	setBC(0x0013);
 	setDE(0x00D8);
 	setHL(0x014D);
 	setSP(0xFFFE);
+
+	m_mmu.mapIO(0xFF0F, this);
+	m_mmu.mapIO(0xFFFF, this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,32 +43,434 @@ void CPU::dump() const
 	);
 }
 
-void CPU::execNextInstructionWithMap(std::map<u8, Instruction>& map)
+void CPU::execNextInstruction()
+{
+	if (m_trace)
+		traceInstruction();
+
+	if (m_profile) {
+		u16 opcode = m_mmu.silent_read8(m_pc);
+		if (opcode == 0xCB)
+			opcode = 0xCB00 | m_mmu.silent_read8(m_pc + 1);
+		m_profile->record(opcode);
+
+		if (m_profile_remaining > 0 && --m_profile_remaining == 0) {
+			selectSuperinstructions(*m_profile);
+			m_profile.reset();
+		}
+	}
+	else if (!m_superinstructions.empty()) {
+		const u8 op_code = m_mmu.silent_read8(m_pc);
+		if (m_superinstruction_heads[op_code] && execSuperinstruction(m_pc, op_code))
+			return;
+	}
+
+	execNextInstructionWithTables(m_handlers, s_instructions);
+}
+
+void CPU::enableProfiling()
+{
+	m_profile = std::make_unique<OpcodeProfile>();
+	m_profile_remaining = 0;
+
+	// Fused sequences would only be recorded by their first opcode
+	m_superinstructions.clear();
+	m_superinstruction_heads.fill(false);
+	m_block_cache.clear();
+}
+
+void CPU::profileSuperinstructions(u64 instructions)
+{
+	enableProfiling();
+	m_profile_remaining = instructions;
+}
+
+void CPU::selectSuperinstructions(const OpcodeProfile& profile)
+{
+	const u64 threshold = std::max<u64>(profile.recorded() / s_superinstruction_share, 1);
+	for (const auto& super : s_superinstructions) {
+		u16 opcodes[4];
+		std::copy(super.ops, super.ops + super.length, opcodes);
+		if (profile.count(opcodes, super.length) < threshold)
+			continue;
+
+		m_superinstructions.push_back(&super);
+		m_superinstruction_heads[super.ops[0]] = true;
+	}
+
+	// Blocks decoded so far were left unfused
+	m_block_cache.clear();
+}
+
+bool CPU::execSuperinstruction(u16 pc, u8 head)
+{
+	// Breakpoints and the trace need to see every instruction
+	if (m_trace || m_has_breakpoints)
+		return false;
+
+	for (const Superinstruction* super : m_superinstructions) {
+		// Never run past the deadline, like blocks
+		if (super->ops[0] != head || m_cycles + super->cycles > m_deadline)
+			continue;
+
+		u16 address = pc;
+		u16 operand = 0;
+		u8 shift = 0;
+		u8 matched = 0;
+		for (; matched < super->length && (matched == 0 || m_mmu.silent_read8(address) == super->ops[matched]); ++matched) {
+			const u8 length = s_instructions[super->ops[matched]].length;
+			for (u8 byte = 1; byte < length; ++byte, shift += 8)
+				operand |= m_mmu.silent_read8(address + byte) << shift;
+			address += length;
+		}
+		if (matched < super->length)
+			continue;
+
+		m_pc = address;
+		m_operand = operand;
+		(this->*super->handler)();
+		m_cycles += super->cycles;
+		return true;
+	}
+	return false;
+}
+
+const char* CPU::mnemonic(u16 opcode)
+{
+	const auto& instructions = (opcode >> 8) == 0xCB ? s_cb_instructions : s_instructions;
+	const char* mnemonic = instructions[opcode & 0xFF].mnemonic;
+	return mnemonic ? mnemonic : "???";
+}
+
+void CPU::execNextInstructionWithTables(const HandlerTable& handlers, const InstructionTable& instructions)
 {
 	u8 op_code = m_mmu.silent_read8(m_pc++);
-	ASSERT_MSG(map.count(op_code) == 1, "Unknown instruction " BG_WHITE "%02X" RESET, op_code);
+	Handler handler = handlers[op_code];
+	ASSERT_MSG(handler != nullptr, "Unknown instruction " BG_WHITE "%02X" RESET, op_code);
 
-	auto insn = map.at(op_code);
-	printf(MAGENTA "%02X" RESET " :: " BLUE "%s" RESET "\n", insn.op, insn.mnemonic);
+	const Instruction& insn = instructions[op_code];
+	if constexpr (Trace::enabled<Trace::Opcodes>)
+		printf(MAGENTA "%02X" RESET " :: " BLUE "%s" RESET "\n", op_code, insn.mnemonic);
 
-	insn.handler();
+	fetchOperand(insn.length);
+	(this->*handler)();
 
 	m_cycles += insn.cycles;
 }
 
+void CPU::execBlocks(u64 deadline)
+{
+	setDeadline(deadline);
+
+	while (!reachedDeadline()) {
+		// Profiling only sees the table interpreter
+		if (m_profile) {
+			execNextInstruction();
+			continue;
+		}
+
+		auto& block = m_block_cache.lookup(m_pc);
+		if (!block.valid && !decodeBlock(block)) {
+			execNextInstruction();
+			continue;
+		}
+
+		// Step through blocks that would run past the deadline, so that
+		// events are never observed late
+		if (m_cycles + block.cycles > m_deadline) {
+			execNextInstruction();
+			continue;
+		}
+
+		const u64 start = m_cycles;
+
+#if BOI_HAS_JIT
+		if (block.native && !m_trace)
+			block.native(*this);
+		else
+#endif
+		{
+			execBlock(block);
+
+#if BOI_HAS_JIT
+			// Blocks that were ever overwritten stay interpreted
+			if (m_jit && !m_trace && !block.breakpoint && ++block.executions == JIT::s_hot_threshold && block.invalidations == 0)
+				block.native = m_jit->compile(block);
+#endif
+		}
+
+		// Polling loops can't observe anything new before the deadline: skip
+		// as many whole iterations as fit
+		if (block.idle_loop && !m_trace && m_pc == block.begin && m_cycles < m_deadline) {
+			const u64 iteration = m_cycles - start;
+			m_cycles += (m_deadline - m_cycles) / iteration * iteration;
+		}
+	}
+}
 
-u8 CPU::imm8()
+#if BOI_HAS_JIT
+void CPU::enableJIT()
 {
-	return m_mmu.read8(m_pc++);
+	if (!m_jit)
+		m_jit = std::make_unique<JIT>(*this, m_block_cache);
 }
+#endif
 
-u16 CPU::imm16()
+void CPU::addBreakpoint(u16 begin, u16 end)
 {
-	u16 value = m_mmu.read16(m_pc);
-	m_pc += 2;
-	return value;
+	for (u32 address = begin; address <= end; ++address)
+		m_breakpoints.set(address);
+	m_has_breakpoints = true;
+	m_handlers = s_breakpoint_traps;
+	m_block_cache.clear();
+}
+
+void CPU::clearBreakpoints()
+{
+	m_breakpoints.reset();
+	m_has_breakpoints = false;
+	m_resume_breakpoint = -1;
+	m_handlers = s_handlers;
+	m_block_cache.clear();
+}
+
+void CPU::setTraceBuffer(TraceBuffer* trace)
+{
+	m_trace = trace;
+	// Blocks decoded so far may hold superinstructions, which skip records
+	m_block_cache.clear();
 }
 
+bool CPU::breakpointHit(u16 address)
+{
+	if (m_resume_breakpoint == address) {
+		m_resume_breakpoint = -1;
+		return false;
+	}
+
+	m_resume_breakpoint = address;
+	m_pc = address;
+	requestExit();
+	if (m_breakpoint_handler)
+		m_breakpoint_handler(address);
+	return true;
+}
+
+void CPU::breakpointOp()
+{
+	if (!breakpointHit(m_pc))
+		execNextInstructionWithTables(s_handlers, s_instructions);
+}
+
+void CPU::execBlock(const BlockCache::Block& block)
+{
+	for (auto& op : block.ops) {
+		if (m_trace)
+			traceInstruction();
+
+		m_pc = op.next_pc;
+		m_operand = op.operand;
+		(this->*op.handler)();
+		m_cycles += op.cycles;
+
+		// The block overwrote its own code, or interrupts were enabled or
+		// requested: leave before the next instruction
+		if (!block.valid || reachedDeadline())
+			break;
+	}
+}
+
+bool CPU::decodeBlock(BlockCache::Block& block)
+{
+	block.begin = m_pc;
+	block.cycles = 0;
+	block.breakpoint = false;
+	block.ops.clear();
+
+	u16 pc = m_pc;
+	while (block.ops.size() < BlockCache::s_max_block_length) {
+		// Breakpoints get blocks of their own
+		if (m_breakpoints[pc]) {
+			if (block.ops.empty()) {
+				block.ops.push_back({ &CPU::breakpointOp, 0, pc, 0, 0x00, false });
+				block.breakpoint = true;
+				pc++;
+			}
+			break;
+		}
+
+		u8 op_code = m_mmu.silent_read8(pc);
+		Handler handler = s_handlers[op_code];
+		const Instruction* insn = &s_instructions[op_code];
+		u16 next_pc = pc + 1;
+		u8 cb_op_code = 0;
+
+		if (op_code == 0xCB) {
+			cb_op_code = m_mmu.silent_read8(next_pc++);
+			handler = s_cb_handlers[cb_op_code];
+			insn = &s_cb_instructions[cb_op_code];
+		}
+
+		// Leave unknown opcodes for the next lookup to report
+		if (handler == nullptr) {
+			ASSERT_MSG(!block.ops.empty(), "Unknown instruction " BG_WHITE "%02X" RESET, op_code);
+			break;
+		}
+
+		u16 operand = 0;
+		if (insn->length == 2)
+			operand = m_mmu.silent_read8(next_pc);
+		else if (insn->length == 3)
+			operand = m_mmu.silent_read8(next_pc) | (m_mmu.silent_read8(next_pc + 1) << 8);
+		next_pc += insn->length - 1;
+
+		// Don't let blocks wrap around the address space, or run from the
+		// fixed ROM bank into the switchable one or from ROM into VRAM: they
+		// are only keyed by the bank they start in. Instructions straddling
+		// one of those boundaries are never cached, but stepped through.
+		bool crosses_bank = (block.begin < 0x4000 && next_pc > 0x4000) || (block.begin < 0x8000 && next_pc > 0x8000);
+		if (block.ops.empty() && crosses_bank)
+			return false;
+		if (!block.ops.empty() && (next_pc <= block.begin || crosses_bank))
+			break;
+
+		bool prefixed = op_code == 0xCB;
+		block.ops.push_back({ handler, operand, next_pc, insn->cycles, prefixed ? cb_op_code : op_code, prefixed });
+		block.cycles += insn->cycles;
+		pc = next_pc;
+
+		if (endsBlock(op_code))
+			break;
+	}
+
+	block.end = pc;
+	block.idle_loop = isIdleLoop(block);
+	if (!m_trace)
+		fuseSuperinstructions(block.ops);
+	m_block_cache.commit(block);
+	return true;
+}
+
+void CPU::fuseSuperinstructions(std::vector<BlockCache::Op>& ops) const
+{
+	auto matches = [&](const Superinstruction& super, size_t at) {
+		if (at + super.length > ops.size())
+			return false;
+		for (size_t i = 0; i < super.length; ++i) {
+			if (ops[at + i].prefixed || ops[at + i].op_code != super.ops[i])
+				return false;
+		}
+		return true;
+	};
+
+	size_t out = 0;
+	for (size_t in = 0; in < ops.size();) {
+		auto it = std::find_if(m_superinstructions.begin(), m_superinstructions.end(), [&](auto* s) { return matches(*s, in); });
+		if (it == m_superinstructions.end()) {
+			ops[out++] = ops[in++];
+			continue;
+		}
+
+		const Superinstruction* super = *it;
+		BlockCache::Op fused = ops[in + super->length - 1];
+		fused.handler = super->handler;
+		fused.op_code = super - s_superinstructions.data();
+		fused.fused = true;
+		fused.operand = 0;
+		fused.cycles = 0;
+
+		u8 shift = 0;
+		for (size_t i = 0; i < super->length; ++i) {
+			const auto& op = ops[in + i];
+			fused.operand |= op.operand << shift;
+			fused.cycles += op.cycles;
+			shift += 8 * (s_instructions[op.op_code].length - 1);
+		}
+
+		ops[out++] = fused;
+		in += super->length;
+	}
+	ops.resize(out);
+}
+
+bool CPU::endsBlock(u8 op_code)
+{
+	switch (op_code) {
+		case 0x10: // STOP
+		case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // JR
+		case 0x76: // HALT
+		case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9: // RET, RETI
+		case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9: // JP
+		case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC: // CALL
+		case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF: // RST
+		case 0xF3: case 0xFB: // DI, EI
+			return true;
+	}
+	return false;
+}
+
+bool CPU::isIdleLoop(const BlockCache::Block& block)
+{
+	// Only events change what the CPU can read, so a loop that reloads A from
+	// a fixed address, tests it and branches back to its start has the same
+	// outcome every time until the next deadline. The timer registers are
+	// derived from the cycle counter and change without events.
+	auto is_event_driven = [](u16 address) {
+		return address != 0xFF04 && address != 0xFF05;
+	};
+
+	if (block.ops.size() < 2)
+		return false;
+
+	const auto& load = block.ops.front();
+	if (load.prefixed)
+		return false;
+	if (load.op_code == 0xF0) { // LDH A,(a8)
+		if (!is_event_driven(0xFF00 + load.operand))
+			return false;
+	}
+	else if (load.op_code == 0xFA) { // LD A,(a16)
+		if (!is_event_driven(load.operand))
+			return false;
+	}
+	else
+		return false;
+
+	for (size_t i = 1; i + 1 < block.ops.size(); ++i) {
+		const auto& op = block.ops[i];
+		// BIT b,A
+		if (op.prefixed && op.op_code >= 0x40 && op.op_code < 0x80 && (op.op_code & 0x07) == 0x07)
+			continue;
+		// AND, XOR, OR and CP, with registers or immediates, only write A and F
+		if (!op.prefixed && ((op.op_code >= 0xA0 && op.op_code < 0xC0 && (op.op_code & 0x07) != 0x06)
+			|| op.op_code == 0xE6 || op.op_code == 0xEE || op.op_code == 0xF6 || op.op_code == 0xFE))
+			continue;
+		return false;
+	}
+
+	const auto& branch = block.ops.back();
+	if (branch.prefixed)
+		return false;
+	switch (branch.op_code) {
+		case 0x20: case 0x28: case 0x30: case 0x38: // JR cc,r8
+			return static_cast<u16>(branch.next_pc + static_cast<i8>(branch.operand)) == block.begin;
+		case 0xC2: case 0xCA: case 0xD2: case 0xDA: // JP cc,a16
+			return branch.operand == block.begin;
+	}
+	return false;
+}
+
+void CPU::fetchOperand(u8 length)
+{
+	if (length == 2)
+		m_operand = m_mmu.fetch8(m_pc++);
+	else if (length == 3) {
+		m_operand = m_mmu.fetch8(m_pc) | (m_mmu.fetch8(m_pc + 1) << 8);
+		m_pc += 2;
+	}
+}
+
+
 void CPU::push8(u8 value)
 {
 	setSP(sp() - sizeof(value));
@@ -94,9 +501,7 @@ u16 CPU::pop16()
 void CPU::bitImpl(u8 bit, u8 value)
 {
 	ASSERT(bit < 8);
-	setFlags(Zero, value & (1 << bit));
-	setFlags(Substract, false);
-	setFlags(HalfCarry, true);
+	setLazyFlagsKeepingCarry(FlagOp::Bit, value & (1 << bit));
 }
 
 void CPU::callImpl(u16 location, bool cond, u8 cycles_on_success)
@@ -110,30 +515,19 @@ void CPU::callImpl(u16 location, bool cond, u8 cycles_on_success)
 
 void CPU::cpImpl(u8 value)
 {
-	setFlags(Zero, a() == value);
-	setFlags(Substract, true);
-	setFlags(HalfCarry, (a() & 0xF) < (value & 0xF));
-	setFlags(Carry, a() < value);
+	m_flags = { FlagOp::Sub, a(), value, static_cast<u8>(a() - value) };
 }
 
 void CPU::decImpl(u8& value)
 {
-	setFlags(Substract, true);
-
 	value--;
-
-	setFlags(Zero, value == 0);
-	setFlags(HalfCarry, (value & 0xF) == 0xF);
+	setLazyFlagsKeepingCarry(FlagOp::Dec, value);
 }
 
 void CPU::incImpl(u8& value)
 {
-	setFlags(Substract, false);
-
 	value++;
-
-	setFlags(Zero, value == 0);
-	setFlags(HalfCarry, (value & 0xF) == 0xF);
+	setLazyFlagsKeepingCarry(FlagOp::Inc, value);
 }
 
 void CPU::jpImpl(u16 location, bool cond, u8 cycles_on_success)
@@ -150,6 +544,63 @@ void CPU::resImpl(u8 bit, u8& value)
 	value &= ~(1 << bit);
 }
 
+void CPU::requestInterrupt(Interrupt interrupt)
+{
+	m_if |= 1 << static_cast<u8>(interrupt);
+	requestExit();
+}
+
+void CPU::serviceInterrupts()
+{
+	if (m_ime_pending && m_cycles >= m_ime_enable_at) {
+		m_ime = true;
+		m_ime_pending = false;
+	}
+
+	u8 pending = m_ie & m_if & 0x1F;
+	if (m_stopped)
+		pending &= 1 << static_cast<u8>(Interrupt::Joypad);
+	if (pending == 0)
+		return;
+
+	m_halted = false;
+	m_stopped = false;
+	if (!m_ime)
+		return;
+
+	u8 bit = __builtin_ctz(pending);
+	m_if &= ~(1 << bit);
+	m_ime = false;
+	push16(m_pc);
+	m_pc = 0x40 + bit * 8;
+	m_cycles += 20;
+}
+
+u8 CPU::readIO(u16 address)
+{
+	switch (address) {
+		case 0xFF0F: return m_if | 0xE0;
+		case 0xFFFF: return m_ie;
+	}
+	ASSERT_NOT_REACHED();
+}
+
+void CPU::writeIO(u16 address, u8 value)
+{
+	switch (address) {
+		case 0xFF0F: m_if = value & 0x1F; break;
+		case 0xFFFF: m_ie = value; break;
+		default: ASSERT_NOT_REACHED();
+	}
+	requestExit();
+}
+
+void CPU::orImpl(u8 value)
+{
+	setA(a() | value);
+	m_flags = { FlagOp::Logic, 0, 0, a() };
+}
+
 void CPU::retImpl(bool cond, u8 cycles_on_success)
 {
 	if (cond) {
@@ -166,616 +617,877 @@ void CPU::setImpl(u8 bit, u8& value)
 
 void CPU::swapImpl(u8& value)
 {
-	resetFlags();
 	value = ((value & 0xF) << 4) | (value >> 4);
-	setFlags(Zero, value == 0);
+	m_flags = { FlagOp::Logic, 0, 0, value };
 }
 
 void CPU::xorImpl(u8 value)
 {
-	resetFlags();
 	setA(a() ^ value);
-	setFlags(Zero, a() == 0);
+	m_flags = { FlagOp::Logic, 0, 0, a() };
+}
+
+u8 CPU::computeFlags() const
+{
+	const u8 zero = m_flags.result == 0 ? Zero : 0;
+	const u8 carry = reg8<RegisterF>() & Carry;
+
+	switch (m_flags.op) {
+		case FlagOp::None:
+			return reg8<RegisterF>();
+		case FlagOp::Sub:
+			return zero | Substract
+				| ((m_flags.lhs & 0xF) < (m_flags.rhs & 0xF) ? HalfCarry : 0)
+				| (m_flags.lhs < m_flags.rhs ? Carry : 0);
+		case FlagOp::Inc:
+			return zero | ((m_flags.result & 0xF) == 0x0 ? HalfCarry : 0) | carry;
+		case FlagOp::Dec:
+			return zero | Substract | ((m_flags.result & 0xF) == 0xF ? HalfCarry : 0) | carry;
+		case FlagOp::Logic:
+			return zero;
+		case FlagOp::Bit:
+			return zero | HalfCarry | carry;
+	}
+	ASSERT_NOT_REACHED();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void CPU::BIT_r8(u8 bit, RegisterIndex8 reg) { bitImpl(bit, reg8(reg)); }
-void CPU::BIT_rp16(u8 bit, RegisterIndex16 ptr) { bitImpl(bit, m_mmu.read8(reg16(ptr))); }
+void CPU::PREFIX_CB() { execNextInstructionWithTables(s_cb_handlers, s_cb_instructions); }
+
+template<u8 Bit, CPU::RegisterIndex8 R> void CPU::BIT_r8() { bitImpl(Bit, reg8<R>()); }
+template<u8 Bit, CPU::RegisterIndex16 P> void CPU::BIT_rp16() { bitImpl(Bit, m_mmu.read8(reg16(P))); }
 
 void CPU::CP_u8() { cpImpl(imm8()); }
-void CPU::CP_r8(RegisterIndex8 reg) { cpImpl(reg8(reg)); }
-void CPU::CP_rp16(RegisterIndex16 reg) { cpImpl(m_mmu.read8(reg16(reg))); }
+template<CPU::RegisterIndex8 R> void CPU::CP_r8() { cpImpl(reg8<R>()); }
+template<CPU::RegisterIndex16 P> void CPU::CP_rp16() { cpImpl(m_mmu.read8(reg16(P))); }
 
 void CPU::CALL_u16() { callImpl(imm16()); }
-void CPU::CALL_C_u16(Flags flag) { callImpl(imm16(), f() & flag, 12); }
-void CPU::CALL_NC_u16(Flags flag) { callImpl(imm16(), !(f() & flag), 12); }
+template<CPU::Flags F> void CPU::CALL_C_u16() { callImpl(imm16(), flag<F>(), 12); }
+template<CPU::Flags F> void CPU::CALL_NC_u16() { callImpl(imm16(), !flag<F>(), 12); }
+
+template<CPU::RegisterIndex8 R> void CPU::DEC_r8() { decImpl(reg8<R>()); }
+template<CPU::RegisterIndex16 R> void CPU::DEC_r16() { reg16(R)--; }
+template<CPU::RegisterIndex16 P> void CPU::DEC_rp16() { u8 value = m_mmu.read8(reg16(P)); decImpl(value); m_mmu.write8(reg16(P), value); }
 
-void CPU::DEC_r8(RegisterIndex8 reg) { decImpl(reg8(reg)); }
-void CPU::DEC_r16(RegisterIndex16 reg) { reg16(reg)--; }
-void CPU::DEC_rp16(RegisterIndex16 ptr) { decImpl(m_mmu.at(reg16(ptr))); }
+void CPU::DI() { m_ime = false; m_ime_pending = false; }
 
-void CPU::INC_r8(RegisterIndex8 reg) { incImpl(reg8(reg)); }
-void CPU::INC_r16(RegisterIndex16 reg) { reg16(reg)++; }
-void CPU::INC_rp16(RegisterIndex16 ptr) { incImpl(m_mmu.at(reg16(ptr))); }
+void CPU::EI()
+{
+	// IME is set after the next instruction, end the run right after it
+	if (m_ime || m_ime_pending)
+		return;
+	m_ime_pending = true;
+	m_ime_enable_at = m_cycles + s_instructions[0xFB].cycles + 1;
+	m_deadline = std::min(m_deadline, m_ime_enable_at);
+}
+
+void CPU::HALT()
+{
+	// With IME reset and an interrupt already pending, HALT ends right away
+	if (!m_ime && (m_ie & m_if & 0x1F))
+		return;
+	m_halted = true;
+	requestExit();
+}
+
+template<CPU::RegisterIndex8 R> void CPU::INC_r8() { incImpl(reg8<R>()); }
+template<CPU::RegisterIndex16 R> void CPU::INC_r16() { reg16(R)++; }
+template<CPU::RegisterIndex16 P> void CPU::INC_rp16() { u8 value = m_mmu.read8(reg16(P)); incImpl(value); m_mmu.write8(reg16(P), value); }
 
 void CPU::JP_u16() { jpImpl(imm16()); }
-void CPU::JP_r16(RegisterIndex16 reg) { jpImpl(reg16(reg)); }
-void CPU::JP_C_u16(Flags flag) { jpImpl(imm16(), f() & flag, 4); }
-void CPU::JP_NC_u16(Flags flag) { jpImpl(imm16(), !(f() & flag), 4); }
+template<CPU::RegisterIndex16 R> void CPU::JP_r16() { jpImpl(reg16(R)); }
+template<CPU::Flags F> void CPU::JP_C_u16() { jpImpl(imm16(), flag<F>(), 4); }
+template<CPU::Flags F> void CPU::JP_NC_u16() { jpImpl(imm16(), !flag<F>(), 4); }
 
 void CPU::JR_i8() { jpImpl(pc() + (i8)imm8()); }
-void CPU::JR_C_i8(Flags flag) { jpImpl(pc() + (i8)imm8(), f() & flag, 4); }
-void CPU::JR_NC_i8(Flags flag) { jpImpl(pc() + (i8)imm8(), !(f() & flag), 4); }
+template<CPU::Flags F> void CPU::JR_C_i8() { jpImpl(pc() + (i8)imm8(), flag<F>(), 4); }
+template<CPU::Flags F> void CPU::JR_NC_i8() { jpImpl(pc() + (i8)imm8(), !flag<F>(), 4); }
+
+template<CPU::RegisterIndex8 R> void CPU::LD_r8_u8() { reg8<R>() = imm8(); }
+template<CPU::RegisterIndex8 R1, CPU::RegisterIndex8 R2> void CPU::LD_r8_r8() { reg8<R1>() = reg8<R2>(); }
+template<CPU::RegisterIndex8 R, CPU::RegisterIndex16 P> void CPU::LD_r8_rp16() { reg8<R>() = m_mmu.read8(reg16(P)); }
+template<CPU::RegisterIndex8 R> void CPU::LD_r8_up16() { reg8<R>() = m_mmu.read8(imm16()); }
+template<CPU::RegisterIndex16 R1, CPU::RegisterIndex16 R2> void CPU::LD_r16_r16() { reg16(R1) = reg16(R2); }
+template<CPU::RegisterIndex16 R1, CPU::RegisterIndex16 R2> void CPU::LD_r16_r16i8() { reg16(R1) = reg16(R2) + (i8)imm8(); }
+template<CPU::RegisterIndex16 R> void CPU::LD_r16_u16() { reg16(R) = imm16(); }
+template<CPU::RegisterIndex16 P, CPU::RegisterIndex8 R> void CPU::LD_rp16_r8() { m_mmu.write8(reg16(P), reg8<R>()); }
+template<CPU::RegisterIndex16 P> void CPU::LD_rp16_u8() { m_mmu.write8(reg16(P), imm8()); }
+template<CPU::RegisterIndex8 R> void CPU::LD_up16_r8() { m_mmu.write8(imm16(), reg8<R>()); }
+template<CPU::RegisterIndex16 R> void CPU::LD_up16_r16() { m_mmu.write16(imm16(), reg16(R)); }
+
+template<CPU::RegisterIndex16 P, CPU::RegisterIndex8 R> void CPU::LDD_rp16_r8() { m_mmu.write8(reg16(P)--, reg8<R>()); }
+
+template<CPU::RegisterIndex8 R> void CPU::LDH_up8_r8() { m_mmu.write8(0xFF00 + imm8(), reg8<R>()); }
+template<CPU::RegisterIndex8 R> void CPU::LDH_r8_up8() { reg8<R>() = m_mmu.read8(0xFF00 + imm8()); }
+
+template<CPU::RegisterIndex8 R, CPU::RegisterIndex16 P> void CPU::LDI_r8_rp16() { reg8<R>() = m_mmu.read8(reg16(P)++); }
+template<CPU::RegisterIndex16 P, CPU::RegisterIndex8 R> void CPU::LDI_rp16_r8() { m_mmu.write8(reg16(P)++, reg8<R>()); }
+
+void CPU::OR_u8() { orImpl(imm8()); }
+template<CPU::RegisterIndex8 R> void CPU::OR_r8() { orImpl(reg8<R>()); }
+template<CPU::RegisterIndex16 P> void CPU::OR_rp16() { orImpl(m_mmu.read8(reg16(P))); }
+
+template<CPU::RegisterIndex16 R> void CPU::POP_r16()
+{
+	if constexpr (R == RegisterAF)
+		setAF(pop16());
+	else
+		reg16(R) = pop16();
+}
+
+template<CPU::RegisterIndex16 R> void CPU::PUSH_r16()
+{
+	if constexpr (R == RegisterAF)
+		push16(af());
+	else
+		push16(reg16(R));
+}
 
-void CPU::LD_r8_u8(RegisterIndex8 reg) { reg8(reg) = imm8(); }
-void CPU::LD_r8_r8(RegisterIndex8 r1, RegisterIndex8 r2) { reg8(r1) = reg8(r2); }
-void CPU::LD_r8_rp16(RegisterIndex8 reg, RegisterIndex16 ptr) { reg8(reg) = m_mmu.read8(reg16(ptr)); }
-void CPU::LD_r8_up16(RegisterIndex8 reg) { reg8(reg) = m_mmu.read8(imm16()); }
-void CPU::LD_r16_r16(RegisterIndex16 r1, RegisterIndex16 r2) { reg16(r1) = reg16(r2); }
-void CPU::LD_r16_r16i8(RegisterIndex16 r1, RegisterIndex16 r2) { reg16(r1) = reg16(r2) + (i8)imm8(); }
-void CPU::LD_r16_u16(RegisterIndex16 reg) { reg16(reg) = imm16(); }
-void CPU::LD_rp16_r8(RegisterIndex16 ptr, RegisterIndex8 reg) { m_mmu.write8(reg16(ptr), reg8(reg)); }
-void CPU::LD_rp16_u8(RegisterIndex16 ptr) { m_mmu.write8(reg16(ptr), imm8()); }
-void CPU::LD_up16_r8(RegisterIndex8 reg) { m_mmu.write8(imm16(), reg8(reg)); }
-void CPU::LD_up16_r16(RegisterIndex16 reg) { m_mmu.write16(imm16(), reg16(reg)); }
+template<u8 Bit, CPU::RegisterIndex8 R> void CPU::RES_r8() { resImpl(Bit, reg8<R>()); }
+template<u8 Bit, CPU::RegisterIndex16 P> void CPU::RES_rp16() { u8 value = m_mmu.read8(reg16(P)); resImpl(Bit, value); m_mmu.write8(reg16(P), value); }
 
-void CPU::LDD_rp16_r8(RegisterIndex16 ptr, RegisterIndex8 reg) { m_mmu.write8(reg16(ptr)--, reg8(reg)); }
+void CPU::RET() { retImpl(); }
+template<CPU::Flags F> void CPU::RET_C() { retImpl(flag<F>(), 12); }
+template<CPU::Flags F> void CPU::RET_NC() { retImpl(!flag<F>(), 12); }
+void CPU::RETI() { retImpl(); m_ime = true; requestExit(); }
 
-void CPU::LDH_up8_r8(RegisterIndex8 reg) { m_mmu.write8(0xFF00 + imm8(), reg8(reg)); }
-void CPU::LDH_r8_up8(RegisterIndex8 reg) { reg8(reg) = m_mmu.read8(0xFF00 + imm8()); }
+template<u8 Location> void CPU::RST() { push16(pc()); m_pc = Location; }
 
-void CPU::LDI_rp16_r8(RegisterIndex16 ptr, RegisterIndex8 reg) { m_mmu.write8(reg16(ptr)++, reg8(reg)); }
+template<u8 Bit, CPU::RegisterIndex8 R> void CPU::SET_r8() { setImpl(Bit, reg8<R>()); }
+template<u8 Bit, CPU::RegisterIndex16 P> void CPU::SET_rp16() { u8 value = m_mmu.read8(reg16(P)); setImpl(Bit, value); m_mmu.write8(reg16(P), value); }
 
-void CPU::POP_r16(RegisterIndex16 reg) { reg16(reg) = pop16(); }
-void CPU::PUSH_r16(RegisterIndex16 reg) { push16(reg16(reg)); }
+void CPU::STOP()
+{
+	m_halted = true;
+	m_stopped = true;
+	requestExit();
+}
 
-void CPU::RES_r8(u8 bit, RegisterIndex8 reg) { resImpl(bit, reg8(reg)); }
-void CPU::RES_rp16(u8 bit, RegisterIndex16 ptr) { resImpl(bit, m_mmu.at(reg16(ptr))); }
+template<CPU::RegisterIndex8 R> void CPU::SWAP_r8() { swapImpl(reg8<R>()); }
+template<CPU::RegisterIndex16 P> void CPU::SWAP_rp16() { u8 value = m_mmu.read8(reg16(P)); swapImpl(value); m_mmu.write8(reg16(P), value); }
 
-void CPU::RET() { retImpl(); }
-void CPU::RET_C(Flags flag) { retImpl(f() & flag, 12); }
-void CPU::RET_NC(Flags flag) { retImpl(!(f() & flag), 12); }
+void CPU::XOR_u8() { xorImpl(imm8()); }
+template<CPU::RegisterIndex8 R> void CPU::XOR_r8() { xorImpl(reg8<R>()); }
+template<CPU::RegisterIndex16 P> void CPU::XOR_rp16() { xorImpl(m_mmu.read16(reg16(P))); }
 
-void CPU::RST(u8 location) { push16(pc()); m_pc = location; }
+////////////////////////////////////////////////////////////////////////////////
 
-void CPU::SET_r8(u8 bit, RegisterIndex8 reg) { setImpl(bit, reg8(reg)); }
-void CPU::SET_rp16(u8 bit, RegisterIndex16 ptr) { setImpl(bit, m_mmu.at(reg16(ptr))); }
+template<size_t N>
+constexpr CPU::HandlerTable CPU::makeHandlerTable(const InstructionDefinition (&definitions)[N])
+{
+	HandlerTable table {};
+	for (auto& i : definitions)
+		table[i.op] = i.handler;
+	return table;
+}
 
-void CPU::SWAP_r8(RegisterIndex8 reg) { swapImpl(reg8(reg)); }
-void CPU::SWAP_rp16(RegisterIndex16 ptr) { swapImpl(m_mmu.at(reg16(ptr))); }
+template<size_t N>
+constexpr CPU::InstructionTable CPU::makeInstructionTable(const InstructionDefinition (&definitions)[N])
+{
+	InstructionTable table {};
+	for (auto& i : definitions)
+		table[i.op] = { i.length, i.cycles, i.mnemonic };
+	return table;
+}
 
-void CPU::XOR_u8() { xorImpl(imm8()); }
-void CPU::XOR_r8(RegisterIndex8 reg) { xorImpl(reg8(reg)); }
-void CPU::XOR_rp16(RegisterIndex16 reg) { xorImpl(m_mmu.read16(reg16(reg))); }
+constexpr CPU::InstructionDefinition CPU::s_definitions[] = {
+	{ 0x00, 1, 4,  "NOP",         &CPU::NOP },
+	{ 0x01, 3, 12, "LD BC,d16",   &CPU::LD_r16_u16<RegisterBC> },
+	{ 0x02, 1, 8,  "LD (BC),A",   &CPU::LD_rp16_r8<RegisterBC, RegisterA> },
+	{ 0x03, 1, 8,  "INC BC",      &CPU::INC_r16<RegisterBC> },
+	{ 0x04, 1, 4,  "INC B",       &CPU::INC_r8<RegisterB> },
+	{ 0x05, 1, 4,  "DEC B",       &CPU::DEC_r8<RegisterB> },
+	{ 0x06, 2, 8,  "LD B,d8",     &CPU::LD_r8_u8<RegisterB> },
+	{ 0x07, 1, 4,  "RLC A",       &CPU::RLC_r8<RegisterA> },
+	{ 0x08, 3, 20, "LD (a16),SP", &CPU::LD_up16_r16<RegisterSP> },
+	{ 0x09, 1, 8,  "ADD HL,BC",   &CPU::ADD_r16_r16<RegisterHL, RegisterBC> },
+	{ 0x0A, 1, 8,  "LD A,(BC)",   &CPU::LD_r8_rp16<RegisterA, RegisterBC> },
+	{ 0x0B, 1, 8,  "DEC BC",      &CPU::DEC_r16<RegisterBC> },
+	{ 0x0C, 1, 4,  "INC C",       &CPU::INC_r8<RegisterC> },
+	{ 0x0D, 1, 4,  "DEC C",       &CPU::DEC_r8<RegisterC> },
+	{ 0x0E, 2, 8,  "LD C,d8",     &CPU::LD_r8_u8<RegisterC> },
+	{ 0x0F, 1, 4,  "RRC A",       &CPU::RRC_r8<RegisterA> },
+	{ 0x10, 2, 4,  "STOP",        &CPU::STOP },
+	{ 0x11, 3, 12, "LD DE,d16",   &CPU::LD_r16_u16<RegisterDE> },
+	{ 0x12, 1, 8,  "LD (DE),A",   &CPU::LD_rp16_r8<RegisterDE, RegisterA> },
+	{ 0x13, 1, 8,  "INC DE",      &CPU::INC_r16<RegisterDE> },
+	{ 0x14, 1, 4,  "INC D",       &CPU::INC_r8<RegisterD> },
+	{ 0x15, 1, 4,  "DEC D",       &CPU::DEC_r8<RegisterD> },
+	{ 0x16, 2, 8,  "LD D,d8",     &CPU::LD_r8_u8<RegisterD> },
+	{ 0x17, 1, 4,  "RL A",        &CPU::RL_r8<RegisterA> },
+	{ 0x18, 2, 12, "JR r8",       &CPU::JR_i8 },
+	{ 0x19, 1, 8,  "ADD HL,DE",   &CPU::ADD_r16_r16<RegisterHL, RegisterDE> },
+	{ 0x1A, 1, 8,  "LD A,(DE)",   &CPU::LD_r8_rp16<RegisterA, RegisterDE> },
+	{ 0x1B, 1, 8,  "DEC DE",      &CPU::DEC_r16<RegisterDE> },
+	{ 0x1C, 1, 4,  "INC E",       &CPU::INC_r8<RegisterE> },
+	{ 0x1D, 1, 4,  "DEC E",       &CPU::DEC_r8<RegisterE> },
+	{ 0x1E, 2, 8,  "LD E,d8",     &CPU::LD_r8_u8<RegisterE> },
+	{ 0x1F, 1, 4,  "RR A",        &CPU::RR_r8<RegisterA> },
+	{ 0x20, 2, 8,  "JR NZ,r8",    &CPU::JR_NC_i8<Zero> },
+	{ 0x21, 3, 12, "LD HL,d16",   &CPU::LD_r16_u16<RegisterHL> },
+	{ 0x22, 1, 8,  "LD (HL+),A",  &CPU::LDI_rp16_r8<RegisterHL, RegisterA> },
+	{ 0x23, 1, 8,  "INC HL",      &CPU::INC_r16<RegisterHL> },
+	{ 0x24, 1, 4,  "INC H",       &CPU::INC_r8<RegisterH> },
+	{ 0x25, 1, 4,  "DEC H",       &CPU::DEC_r8<RegisterH> },
+	{ 0x26, 2, 8,  "LD H,d8",     &CPU::LD_r8_u8<RegisterH> },
+	{ 0x27, 1, 4,  "DAA",         &CPU::DAA },
+	{ 0x28, 2, 8,  "JR Z,r8",     &CPU::JR_C_i8<Zero> },
+	{ 0x29, 1, 8,  "ADD HL,HL",   &CPU::ADD_r16_r16<RegisterHL, RegisterHL> },
+	{ 0x2A, 1, 8,  "LD A,(HL+)",  &CPU::LDI_r8_rp16<RegisterA, RegisterHL> },
+	{ 0x2B, 1, 8,  "DEC HL",      &CPU::DEC_r16<RegisterHL> },
+	{ 0x2C, 1, 4,  "INC L",       &CPU::INC_r8<RegisterL> },
+	{ 0x2D, 1, 4,  "DEC L",       &CPU::DEC_r8<RegisterL> },
+	{ 0x2E, 2, 8,  "LD L,d8",     &CPU::LD_r8_u8<RegisterL> },
+	{ 0x2F, 1, 4,  "CPL",         &CPU::CPL },
+	{ 0x30, 2, 8,  "JR NC,r8",    &CPU::JR_NC_i8<Carry> },
+	{ 0x31, 3, 12, "LD SP,d16",   &CPU::LD_r16_u16<RegisterSP> },
+	{ 0x32, 1, 8,  "LD (HL-),A",  &CPU::LDD_rp16_r8<RegisterHL, RegisterA> },
+	{ 0x33, 1, 8,  "INC SP",      &CPU::INC_r16<RegisterSP> },
+	{ 0x34, 1, 12, "INC (HL)",    &CPU::INC_rp16<RegisterHL> },
+	{ 0x35, 1, 12, "DEC (HL)",    &CPU::DEC_rp16<RegisterHL> },
+	{ 0x36, 2, 12, "LD (HL),d8",  &CPU::LD_rp16_u8<RegisterHL> },
+	{ 0x37, 1, 4,  "SCF",         &CPU::SCF },
+	{ 0x38, 2, 8,  "JR C,r8",     &CPU::JR_C_i8<Carry> },
+	{ 0x39, 1, 8,  "ADD HL,SP",   &CPU::ADD_r16_r16<RegisterHL, RegisterSP> },
+	{ 0x3A, 1, 8,  "LD A,(HL-)",  &CPU::LDD_r8_rp16<RegisterA, RegisterHL> },
+	{ 0x3B, 1, 8,  "DEC SP",      &CPU::DEC_r16<RegisterSP> },
+	{ 0x3C, 1, 4,  "INC A",       &CPU::INC_r8<RegisterA> },
+	{ 0x3D, 1, 4,  "DEC A",       &CPU::DEC_r8<RegisterA> },
+	{ 0x3E, 2, 8,  "LD A,d8",     &CPU::LD_r8_u8<RegisterA> },
+	{ 0x3F, 1, 4,  "CCF",         &CPU::CCF },
+	{ 0x40, 1, 4,  "LD B,B",      &CPU::LD_r8_r8<RegisterB, RegisterB> },
+	{ 0x41, 1, 4,  "LD B,C",      &CPU::LD_r8_r8<RegisterB, RegisterC> },
+	{ 0x42, 1, 4,  "LD B,D",      &CPU::LD_r8_r8<RegisterB, RegisterD> },
+	{ 0x43, 1, 4,  "LD B,E",      &CPU::LD_r8_r8<RegisterB, RegisterE> },
+	{ 0x44, 1, 4,  "LD B,H",      &CPU::LD_r8_r8<RegisterB, RegisterH> },
+	{ 0x45, 1, 4,  "LD B,L",      &CPU::LD_r8_r8<RegisterB, RegisterL> },
+	{ 0x46, 1, 8,  "LD B,(HL)",   &CPU::LD_r8_rp16<RegisterB, RegisterHL> },
+	{ 0x47, 1, 4,  "LD B,A",      &CPU::LD_r8_r8<RegisterB, RegisterA> },
+	{ 0x48, 1, 4,  "LD C,B",      &CPU::LD_r8_r8<RegisterC, RegisterB> },
+	{ 0x49, 1, 4,  "LD C,C",      &CPU::LD_r8_r8<RegisterC, RegisterC> },
+	{ 0x4A, 1, 4,  "LD C,D",      &CPU::LD_r8_r8<RegisterC, RegisterD> },
+	{ 0x4B, 1, 4,  "LD C,E",      &CPU::LD_r8_r8<RegisterC, RegisterE> },
+	{ 0x4C, 1, 4,  "LD C,H",      &CPU::LD_r8_r8<RegisterC, RegisterH> },
+	{ 0x4D, 1, 4,  "LD C,L",      &CPU::LD_r8_r8<RegisterC, RegisterL> },
+	{ 0x4E, 1, 8,  "LD C,(HL)",   &CPU::LD_r8_rp16<RegisterC, RegisterHL> },
+	{ 0x4F, 1, 4,  "LD C,A",      &CPU::LD_r8_r8<RegisterC, RegisterA> },
+	{ 0x50, 1, 4,  "LD D,B",      &CPU::LD_r8_r8<RegisterD, RegisterB> },
+	{ 0x51, 1, 4,  "LD D,C",      &CPU::LD_r8_r8<RegisterD, RegisterC> },
+	{ 0x52, 1, 4,  "LD D,D",      &CPU::LD_r8_r8<RegisterD, RegisterD> },
+	{ 0x53, 1, 4,  "LD D,E",      &CPU::LD_r8_r8<RegisterD, RegisterE> },
+	{ 0x54, 1, 4,  "LD D,H",      &CPU::LD_r8_r8<RegisterD, RegisterH> },
+	{ 0x55, 1, 4,  "LD D,L",      &CPU::LD_r8_r8<RegisterD, RegisterL> },
+	{ 0x56, 1, 8,  "LD D,(HL)",   &CPU::LD_r8_rp16<RegisterD, RegisterHL> },
+	{ 0x57, 1, 4,  "LD D,A",      &CPU::LD_r8_r8<RegisterD, RegisterA> },
+	{ 0x58, 1, 4,  "LD E,B",      &CPU::LD_r8_r8<RegisterE, RegisterB> },
+	{ 0x59, 1, 4,  "LD E,C",      &CPU::LD_r8_r8<RegisterE, RegisterC> },
+	{ 0x5A, 1, 4,  "LD E,D",      &CPU::LD_r8_r8<RegisterE, RegisterD> },
+	{ 0x5B, 1, 4,  "LD E,E",      &CPU::LD_r8_r8<RegisterE, RegisterE> },
+	{ 0x5C, 1, 4,  "LD E,H",      &CPU::LD_r8_r8<RegisterE, RegisterH> },
+	{ 0x5D, 1, 4,  "LD E,L",      &CPU::LD_r8_r8<RegisterE, RegisterL> },
+	{ 0x5E, 1, 8,  "LD E,(HL)",   &CPU::LD_r8_rp16<RegisterE, RegisterHL> },
+	{ 0x5F, 1, 4,  "LD E,A",      &CPU::LD_r8_r8<RegisterE, RegisterA> },
+	{ 0x60, 1, 4,  "LD H,B",      &CPU::LD_r8_r8<RegisterH, RegisterB> },
+	{ 0x61, 1, 4,  "LD H,C",      &CPU::LD_r8_r8<RegisterH, RegisterC> },
+	{ 0x62, 1, 4,  "LD H,D",      &CPU::LD_r8_r8<RegisterH, RegisterD> },
+	{ 0x63, 1, 4,  "LD H,E",      &CPU::LD_r8_r8<RegisterH, RegisterE> },
+	{ 0x64, 1, 4,  "LD H,H",      &CPU::LD_r8_r8<RegisterH, RegisterH> },
+	{ 0x65, 1, 4,  "LD H,L",      &CPU::LD_r8_r8<RegisterH, RegisterL> },
+	{ 0x66, 1, 8,  "LD H,(HL)",   &CPU::LD_r8_rp16<RegisterH, RegisterHL> },
+	{ 0x67, 1, 4,  "LD H,A",      &CPU::LD_r8_r8<RegisterH, RegisterA> },
+	{ 0x68, 1, 4,  "LD L,B",      &CPU::LD_r8_r8<RegisterL, RegisterB> },
+	{ 0x69, 1, 4,  "LD L,C",      &CPU::LD_r8_r8<RegisterL, RegisterC> },
+	{ 0x6A, 1, 4,  "LD L,D",      &CPU::LD_r8_r8<RegisterL, RegisterD> },
+	{ 0x6B, 1, 4,  "LD L,E",      &CPU::LD_r8_r8<RegisterL, RegisterE> },
+	{ 0x6C, 1, 4,  "LD L,H",      &CPU::LD_r8_r8<RegisterL, RegisterH> },
+	{ 0x6D, 1, 4,  "LD L,L",      &CPU::LD_r8_r8<RegisterL, RegisterL> },
+	{ 0x6E, 1, 8,  "LD L,(HL)",   &CPU::LD_r8_rp16<RegisterL, RegisterHL> },
+	{ 0x6F, 1, 4,  "LD L,A",      &CPU::LD_r8_r8<RegisterL, RegisterA> },
+	{ 0x70, 1, 8,  "LD (HL),B",   &CPU::LD_rp16_r8<RegisterHL, RegisterB> },
+	{ 0x71, 1, 8,  "LD (HL),C",   &CPU::LD_rp16_r8<RegisterHL, RegisterC> },
+	{ 0x72, 1, 8,  "LD (HL),D",   &CPU::LD_rp16_r8<RegisterHL, RegisterD> },
+	{ 0x73, 1, 8,  "LD (HL),E",   &CPU::LD_rp16_r8<RegisterHL, RegisterE> },
+	{ 0x74, 1, 8,  "LD (HL),H",   &CPU::LD_rp16_r8<RegisterHL, RegisterH> },
+	{ 0x75, 1, 8,  "LD (HL),L",   &CPU::LD_rp16_r8<RegisterHL, RegisterL> },
+	{ 0x76, 1, 4,  "HALT",        &CPU::HALT },
+	{ 0x77, 1, 8,  "LD (HL),A",   &CPU::LD_rp16_r8<RegisterHL, RegisterA> },
+	{ 0x78, 1, 4,  "LD A,B",      &CPU::LD_r8_r8<RegisterA, RegisterB> },
+	{ 0x79, 1, 4,  "LD A,C",      &CPU::LD_r8_r8<RegisterA, RegisterC> },
+	{ 0x7A, 1, 4,  "LD A,D",      &CPU::LD_r8_r8<RegisterA, RegisterD> },
+	{ 0x7B, 1, 4,  "LD A,E",      &CPU::LD_r8_r8<RegisterA, RegisterE> },
+	{ 0x7C, 1, 4,  "LD A,H",      &CPU::LD_r8_r8<RegisterA, RegisterH> },
+	{ 0x7D, 1, 4,  "LD A,L",      &CPU::LD_r8_r8<RegisterA, RegisterL> },
+	{ 0x7E, 1, 8,  "LD A,(HL)",   &CPU::LD_r8_rp16<RegisterA, RegisterHL> },
+	{ 0x7F, 1, 4,  "LD A,A",      &CPU::LD_r8_r8<RegisterA, RegisterA> },
+	{ 0x80, 1, 4,  "ADD A,B",     &CPU::ADD_r8_r8<RegisterA, RegisterB> },
+	{ 0x81, 1, 4,  "ADD A,C",     &CPU::ADD_r8_r8<RegisterA, RegisterC> },
+	{ 0x82, 1, 4,  "ADD A,D",     &CPU::ADD_r8_r8<RegisterA, RegisterD> },
+	{ 0x83, 1, 4,  "ADD A,E",     &CPU::ADD_r8_r8<RegisterA, RegisterE> },
+	{ 0x84, 1, 4,  "ADD A,H",     &CPU::ADD_r8_r8<RegisterA, RegisterH> },
+	{ 0x85, 1, 4,  "ADD A,L",     &CPU::ADD_r8_r8<RegisterA, RegisterL> },
+	{ 0x86, 1, 8,  "ADD A,(HL)",  &CPU::ADD_r8_rp16<RegisterA, RegisterHL> },
+	{ 0x87, 1, 4,  "ADD A,A",     &CPU::ADD_r8_r8<RegisterA, RegisterA> },
+	{ 0x88, 1, 4,  "ADC A,B",     &CPU::ADC_r8_r8<RegisterA, RegisterB> },
+	{ 0x89, 1, 4,  "ADC A,C",     &CPU::ADC_r8_r8<RegisterA, RegisterC> },
+	{ 0x8A, 1, 4,  "ADC A,D",     &CPU::ADC_r8_r8<RegisterA, RegisterD> },
+	{ 0x8B, 1, 4,  "ADC A,E",     &CPU::ADC_r8_r8<RegisterA, RegisterE> },
+	{ 0x8C, 1, 4,  "ADC A,H",     &CPU::ADC_r8_r8<RegisterA, RegisterH> },
+	{ 0x8D, 1, 4,  "ADC A,L",     &CPU::ADC_r8_r8<RegisterA, RegisterL> },
+	{ 0x8E, 1, 8,  "ADC A,(HL)",  &CPU::ADC_r8_rp16<RegisterA, RegisterHL> },
+	{ 0x8F, 1, 4,  "ADC A,A",     &CPU::ADC_r8_r8<RegisterA, RegisterA> },
+	{ 0x90, 1, 4,  "SUB B",       &CPU::SUB_r8<RegisterB> },
+	{ 0x91, 1, 4,  "SUB C",       &CPU::SUB_r8<RegisterC> },
+	{ 0x92, 1, 4,  "SUB D",       &CPU::SUB_r8<RegisterD> },
+	{ 0x93, 1, 4,  "SUB E",       &CPU::SUB_r8<RegisterE> },
+	{ 0x94, 1, 4,  "SUB H",       &CPU::SUB_r8<RegisterH> },
+	{ 0x95, 1, 4,  "SUB L",       &CPU::SUB_r8<RegisterL> },
+	{ 0x96, 1, 8,  "SUB (HL)",    &CPU::SUB_rp16<RegisterHL> },
+	{ 0x97, 1, 4,  "SUB A",       &CPU::SUB_r8<RegisterA> },
+	{ 0x98, 1, 4,  "SBC A,B",     &CPU::SBC_r8_r8<RegisterA, RegisterB> },
+	{ 0x99, 1, 4,  "SBC A,C",     &CPU::SBC_r8_r8<RegisterA, RegisterC> },
+	{ 0x9A, 1, 4,  "SBC A,D",     &CPU::SBC_r8_r8<RegisterA, RegisterD> },
+	{ 0x9B, 1, 4,  "SBC A,E",     &CPU::SBC_r8_r8<RegisterA, RegisterE> },
+	{ 0x9C, 1, 4,  "SBC A,H",     &CPU::SBC_r8_r8<RegisterA, RegisterH> },
+	{ 0x9D, 1, 4,  "SBC A,L",     &CPU::SBC_r8_r8<RegisterA, RegisterL> },
+	{ 0x9E, 1, 8,  "SBC A,(HL)",  &CPU::SBC_r8_rp16<RegisterA, RegisterHL> },
+	{ 0x9F, 1, 4,  "SBC A,A",     &CPU::SBC_r8_r8<RegisterA, RegisterA> },
+	{ 0xA0, 1, 4,  "AND B",       &CPU::AND_r8<RegisterB> },
+	{ 0xA1, 1, 4,  "AND C",       &CPU::AND_r8<RegisterC> },
+	{ 0xA2, 1, 4,  "AND D",       &CPU::AND_r8<RegisterD> },
+	{ 0xA3, 1, 4,  "AND E",       &CPU::AND_r8<RegisterE> },
+	{ 0xA4, 1, 4,  "AND H",       &CPU::AND_r8<RegisterH> },
+	{ 0xA5, 1, 4,  "AND L",       &CPU::AND_r8<RegisterL> },
+	{ 0xA6, 1, 8,  "AND (HL)",    &CPU::AND_rp16<RegisterHL> },
+	{ 0xA7, 1, 4,  "AND A",       &CPU::AND_r8<RegisterA> },
+	{ 0xA8, 1, 4,  "XOR B",       &CPU::XOR_r8<RegisterB> },
+	{ 0xA9, 1, 4,  "XOR C",       &CPU::XOR_r8<RegisterC> },
+	{ 0xAA, 1, 4,  "XOR D",       &CPU::XOR_r8<RegisterD> },
+	{ 0xAB, 1, 4,  "XOR E",       &CPU::XOR_r8<RegisterE> },
+	{ 0xAC, 1, 4,  "XOR H",       &CPU::XOR_r8<RegisterH> },
+	{ 0xAD, 1, 4,  "XOR L",       &CPU::XOR_r8<RegisterL> },
+	{ 0xAE, 1, 8,  "XOR (HL)",    &CPU::XOR_rp16<RegisterHL> },
+	{ 0xAF, 1, 4,  "XOR A",       &CPU::XOR_r8<RegisterA> },
+	{ 0xB0, 1, 4,  "OR B",        &CPU::OR_r8<RegisterB> },
+	{ 0xB1, 1, 4,  "OR C",        &CPU::OR_r8<RegisterC> },
+	{ 0xB2, 1, 4,  "OR D",        &CPU::OR_r8<RegisterD> },
+	{ 0xB3, 1, 4,  "OR E",        &CPU::OR_r8<RegisterE> },
+	{ 0xB4, 1, 4,  "OR H",        &CPU::OR_r8<RegisterH> },
+	{ 0xB5, 1, 4,  "OR L",        &CPU::OR_r8<RegisterL> },
+	{ 0xB6, 1, 8,  "OR (HL)",     &CPU::OR_rp16<RegisterHL> },
+	{ 0xB7, 1, 4,  "OR A",        &CPU::OR_r8<RegisterA> },
+	{ 0xB8, 1, 4,  "CP B",        &CPU::CP_r8<RegisterB> },
+	{ 0xB9, 1, 4,  "CP C",        &CPU::CP_r8<RegisterC> },
+	{ 0xBA, 1, 4,  "CP D",        &CPU::CP_r8<RegisterD> },
+	{ 0xBB, 1, 4,  "CP E",        &CPU::CP_r8<RegisterE> },
+	{ 0xBC, 1, 4,  "CP H",        &CPU::CP_r8<RegisterH> },
+	{ 0xBD, 1, 4,  "CP L",        &CPU::CP_r8<RegisterL> },
+	{ 0xBE, 1, 8,  "CP (HL)",     &CPU::CP_rp16<RegisterHL> },
+	{ 0xBF, 1, 4,  "CP A",        &CPU::CP_r8<RegisterA> },
+	{ 0xC0, 1, 8,  "RET NZ",      &CPU::RET_NC<Zero> },
+	{ 0xC1, 1, 12, "POP BC",      &CPU::POP_r16<RegisterBC> },
+	{ 0xC2, 3, 12, "JP NZ,a16",   &CPU::JP_NC_u16<Zero> },
+	{ 0xC3, 3, 16, "JP a16",      &CPU::JP_u16 },
+	{ 0xC4, 3, 12, "CALL NZ,a16", &CPU::CALL_NC_u16<Zero> },
+	{ 0xC5, 1, 16, "PUSH BC",     &CPU::PUSH_r16<RegisterBC> },
+	{ 0xC6, 2, 8,  "ADD A,d8",    &CPU::ADD_r8_u8<RegisterA> },
+	{ 0xC7, 1, 16, "RST 00",      &CPU::RST<0x00> },
+	{ 0xC8, 1, 8,  "RET Z",       &CPU::RET_C<Zero> },
+	{ 0xC9, 1, 16, "RET",         &CPU::RET },
+	{ 0xCA, 3, 12, "JP Z,a16",    &CPU::JP_C_u16<Zero> },
+	{ 0xCB, 1, 0,  "PREFIX CB",   &CPU::PREFIX_CB },
+	{ 0xCC, 3, 12, "CALL Z,a16",  &CPU::CALL_C_u16<Zero> },
+	{ 0xCD, 3, 24, "CALL a16",    &CPU::CALL_u16 },
+	{ 0xCE, 2, 8,  "ADC A,d8",    &CPU::ADC_r8_u8<RegisterA> },
+	{ 0xCF, 1, 16, "RST 08",      &CPU::RST<0x08> },
+	{ 0xD0, 1, 8,  "RET NC",      &CPU::RET_NC<Carry> },
+	{ 0xD1, 1, 12, "POP DE",      &CPU::POP_r16<RegisterDE> },
+	{ 0xD2, 3, 12, "JP NC,a16",   &CPU::JP_NC_u16<Carry> },
+	{ 0xD4, 3, 12, "CALL NC,a16", &CPU::CALL_NC_u16<Carry> },
+	{ 0xD5, 1, 16, "PUSH DE",     &CPU::PUSH_r16<RegisterDE> },
+	{ 0xD6, 2, 8,  "SUB d8",      &CPU::SUB_u8 },
+	{ 0xD7, 1, 16, "RST 10",      &CPU::RST<0x10> },
+	{ 0xD8, 1, 8,  "RET C",       &CPU::RET_C<Carry> },
+	{ 0xD9, 1, 16, "RETI",        &CPU::RETI },
+	{ 0xDA, 3, 12, "JP C,a16",    &CPU::JP_C_u16<Carry> },
+	{ 0xDC, 3, 12, "CALL C,a16",  &CPU::CALL_C_u16<Carry> },
+	{ 0xDE, 2, 8,  "SBC A,d8",    &CPU::SBC_r8_u8<RegisterA> },
+	{ 0xDF, 1, 16, "RST 18",      &CPU::RST<0x18> },
+	{ 0xE0, 2, 12, "LDH (a8),A",  &CPU::LDH_up8_r8<RegisterA> },
+	{ 0xE1, 1, 12, "POP HL",      &CPU::POP_r16<RegisterHL> },
+	{ 0xE2, 1, 8,  "LD (C),A",    &CPU::LDH_rp8_r8<RegisterC, RegisterA> },
+	{ 0xE5, 1, 16, "PUSH HL",     &CPU::PUSH_r16<RegisterHL> },
+	{ 0xE6, 2, 8,  "AND d8",      &CPU::AND_u8 },
+	{ 0xE7, 1, 16, "RST 20",      &CPU::RST<0x20> },
+	{ 0xE8, 2, 16, "ADD SP,r8",   &CPU::ADD_r16_i8<RegisterHL> },
+	{ 0xE9, 1, 4,  "JP (HL)",     &CPU::JP_r16<RegisterHL> },
+	{ 0xEA, 3, 16, "LD (a16),A",  &CPU::LD_up16_r8<RegisterA> },
+	{ 0xEE, 2, 8,  "XOR d8",      &CPU::XOR_u8 },
+	{ 0xEF, 1, 16, "RST 28",      &CPU::RST<0x28> },
+	{ 0xF0, 2, 12, "LDH A,(a8)",  &CPU::LDH_r8_up8<RegisterA> },
+	{ 0xF1, 1, 12, "POP AF",      &CPU::POP_r16<RegisterAF> },
+	{ 0xF2, 1, 8,  "LD A,(C)",    &CPU::LDH_r8_rp8<RegisterA, RegisterC> },
+	{ 0xF3, 1, 4,  "DI",          &CPU::DI },
+	{ 0xF5, 1, 16, "PUSH AF",     &CPU::PUSH_r16<RegisterAF> },
+	{ 0xF6, 2, 8,  "OR d8",       &CPU::OR_u8 },
+	{ 0xF7, 1, 16, "RST 30",      &CPU::RST<0x30> },
+	{ 0xF8, 2, 12, "LD HL,SP+r8", &CPU::LD_r16_r16i8<RegisterHL, RegisterSP> },
+	{ 0xF9, 1, 8,  "LD SP,HL",    &CPU::LD_r16_r16<RegisterSP, RegisterHL> },
+	{ 0xFA, 3, 16, "LD A,(a16)",  &CPU::LD_r8_up16<RegisterA> },
+	{ 0xFB, 1, 4,  "EI",          &CPU::EI },
+	{ 0xFE, 2, 8,  "CP d8",       &CPU::CP_u8 },
+	{ 0xFF, 1, 16, "RST 38",      &CPU::RST<0x38> },
+};
+
+constexpr CPU::InstructionDefinition CPU::s_cb_definitions[] = {
+	{ 0x00, 1, 8,  "RLC B",      &CPU::RLC_r8<RegisterB> },
+	{ 0x01, 1, 8,  "RLC C",      &CPU::RLC_r8<RegisterC> },
+	{ 0x02, 1, 8,  "RLC D",      &CPU::RLC_r8<RegisterD> },
+	{ 0x03, 1, 8,  "RLC E",      &CPU::RLC_r8<RegisterE> },
+	{ 0x04, 1, 8,  "RLC H",      &CPU::RLC_r8<RegisterH> },
+	{ 0x05, 1, 8,  "RLC L",      &CPU::RLC_r8<RegisterL> },
+	{ 0x06, 1, 16, "RLC (HL)",   &CPU::RLC_rp16<RegisterHL> },
+	{ 0x07, 1, 8,  "RLC A",      &CPU::RLC_r8<RegisterA> },
+	{ 0x08, 1, 8,  "RRC B",      &CPU::RRC_r8<RegisterB> },
+	{ 0x09, 1, 8,  "RRC C",      &CPU::RRC_r8<RegisterC> },
+	{ 0x0A, 1, 8,  "RRC D",      &CPU::RRC_r8<RegisterD> },
+	{ 0x0B, 1, 8,  "RRC E",      &CPU::RRC_r8<RegisterE> },
+	{ 0x0C, 1, 8,  "RRC H",      &CPU::RRC_r8<RegisterH> },
+	{ 0x0D, 1, 8,  "RRC L",      &CPU::RRC_r8<RegisterL> },
+	{ 0x0E, 1, 16, "RRC (HL)",   &CPU::RRC_rp16<RegisterHL> },
+	{ 0x0F, 1, 8,  "RRC A",      &CPU::RRC_r8<RegisterA> },
+	{ 0x10, 1, 8,  "RL B",       &CPU::RL_r8<RegisterB> },
+	{ 0x11, 1, 8,  "RL C",       &CPU::RL_r8<RegisterC> },
+	{ 0x12, 1, 8,  "RL D",       &CPU::RL_r8<RegisterD> },
+	{ 0x13, 1, 8,  "RL E",       &CPU::RL_r8<RegisterE> },
+	{ 0x14, 1, 8,  "RL H",       &CPU::RL_r8<RegisterH> },
+	{ 0x15, 1, 8,  "RL L",       &CPU::RL_r8<RegisterL> },
+	{ 0x16, 1, 16, "RL (HL)",    &CPU::RL_rp16<RegisterHL> },
+	{ 0x17, 1, 8,  "RL A",       &CPU::RL_r8<RegisterA> },
+	{ 0x18, 1, 8,  "RR B",       &CPU::RR_r8<RegisterB> },
+	{ 0x19, 1, 8,  "RR C",       &CPU::RR_r8<RegisterC> },
+	{ 0x1A, 1, 8,  "RR D",       &CPU::RR_r8<RegisterD> },
+	{ 0x1B, 1, 8,  "RR E",       &CPU::RR_r8<RegisterE> },
+	{ 0x1C, 1, 8,  "RR H",       &CPU::RR_r8<RegisterH> },
+	{ 0x1D, 1, 8,  "RR L",       &CPU::RR_r8<RegisterL> },
+	{ 0x1E, 1, 16, "RR (HL)",    &CPU::RR_rp16<RegisterHL> },
+	{ 0x1F, 1, 8,  "RR A",       &CPU::RR_r8<RegisterA> },
+	{ 0x20, 1, 8,  "SLA B",      &CPU::SLA_r8<RegisterB> },
+	{ 0x21, 1, 8,  "SLA C",      &CPU::SLA_r8<RegisterC> },
+	{ 0x22, 1, 8,  "SLA D",      &CPU::SLA_r8<RegisterD> },
+	{ 0x23, 1, 8,  "SLA E",      &CPU::SLA_r8<RegisterE> },
+	{ 0x24, 1, 8,  "SLA H",      &CPU::SLA_r8<RegisterH> },
+	{ 0x25, 1, 8,  "SLA L",      &CPU::SLA_r8<RegisterL> },
+	{ 0x26, 1, 16, "SLA (HL)",   &CPU::SLA_rp16<RegisterHL> },
+	{ 0x27, 1, 8,  "SLA A",      &CPU::SLA_r8<RegisterA> },
+	{ 0x28, 1, 8,  "SRA B",      &CPU::SRA_r8<RegisterB> },
+	{ 0x29, 1, 8,  "SRA C",      &CPU::SRA_r8<RegisterC> },
+	{ 0x2A, 1, 8,  "SRA D",      &CPU::SRA_r8<RegisterD> },
+	{ 0x2B, 1, 8,  "SRA E",      &CPU::SRA_r8<RegisterE> },
+	{ 0x2C, 1, 8,  "SRA H",      &CPU::SRA_r8<RegisterH> },
+	{ 0x2D, 1, 8,  "SRA L",      &CPU::SRA_r8<RegisterL> },
+	{ 0x2E, 1, 16, "SRA (HL)",   &CPU::SRA_rp16<RegisterHL> },
+	{ 0x2F, 1, 8,  "SRA A",      &CPU::SRA_r8<RegisterA> },
+	{ 0x30, 1, 8,  "SWAP B",     &CPU::SWAP_r8<RegisterB> },
+	{ 0x31, 1, 8,  "SWAP C",     &CPU::SWAP_r8<RegisterC> },
+	{ 0x32, 1, 8,  "SWAP D",     &CPU::SWAP_r8<RegisterD> },
+	{ 0x33, 1, 8,  "SWAP E",     &CPU::SWAP_r8<RegisterE> },
+	{ 0x34, 1, 8,  "SWAP H",     &CPU::SWAP_r8<RegisterH> },
+	{ 0x35, 1, 8,  "SWAP L",     &CPU::SWAP_r8<RegisterL> },
+	{ 0x36, 1, 16, "SWAP (HL)",  &CPU::SWAP_rp16<RegisterHL> },
+	{ 0x37, 1, 8,  "SWAP A",     &CPU::SWAP_r8<RegisterA> },
+	{ 0x38, 1, 8,  "SRL B",      &CPU::SRL_r8<RegisterB> },
+	{ 0x39, 1, 8,  "SRL C",      &CPU::SRL_r8<RegisterC> },
+	{ 0x3A, 1, 8,  "SRL D",      &CPU::SRL_r8<RegisterD> },
+	{ 0x3B, 1, 8,  "SRL E",      &CPU::SRL_r8<RegisterE> },
+	{ 0x3C, 1, 8,  "SRL H",      &CPU::SRL_r8<RegisterH> },
+	{ 0x3D, 1, 8,  "SRL L",      &CPU::SRL_r8<RegisterL> },
+	{ 0x3E, 1, 16, "SRL (HL)",   &CPU::SRL_rp16<RegisterHL> },
+	{ 0x3F, 1, 8,  "SRL A",      &CPU::SRL_r8<RegisterA> },
+	{ 0x40, 1, 8,  "BIT 0,B",    &CPU::BIT_r8<0, RegisterB> },
+	{ 0x41, 1, 8,  "BIT 0,C",    &CPU::BIT_r8<0, RegisterC> },
+	{ 0x42, 1, 8,  "BIT 0,D",    &CPU::BIT_r8<0, RegisterD> },
+	{ 0x43, 1, 8,  "BIT 0,E",    &CPU::BIT_r8<0, RegisterE> },
+	{ 0x44, 1, 8,  "BIT 0,H",    &CPU::BIT_r8<0, RegisterH> },
+	{ 0x45, 1, 8,  "BIT 0,L",    &CPU::BIT_r8<0, RegisterL> },
+	{ 0x46, 1, 16, "BIT 0,(HL)", &CPU::BIT_rp16<0, RegisterHL> },
+	{ 0x47, 1, 8,  "BIT 0,A",    &CPU::BIT_r8<0, RegisterA> },
+	{ 0x48, 1, 8,  "BIT 1,B",    &CPU::BIT_r8<1, RegisterB> },
+	{ 0x49, 1, 8,  "BIT 1,C",    &CPU::BIT_r8<1, RegisterC> },
+	{ 0x4A, 1, 8,  "BIT 1,D",    &CPU::BIT_r8<1, RegisterD> },
+	{ 0x4B, 1, 8,  "BIT 1,E",    &CPU::BIT_r8<1, RegisterE> },
+	{ 0x4C, 1, 8,  "BIT 1,H",    &CPU::BIT_r8<1, RegisterH> },
+	{ 0x4D, 1, 8,  "BIT 1,L",    &CPU::BIT_r8<1, RegisterL> },
+	{ 0x4E, 1, 16, "BIT 1,(HL)", &CPU::BIT_rp16<1, RegisterHL> },
+	{ 0x4F, 1, 8,  "BIT 1,A",    &CPU::BIT_r8<1, RegisterA> },
+	{ 0x50, 1, 8,  "BIT 2,B",    &CPU::BIT_r8<2, RegisterB> },
+	{ 0x51, 1, 8,  "BIT 2,C",    &CPU::BIT_r8<2, RegisterC> },
+	{ 0x52, 1, 8,  "BIT 2,D",    &CPU::BIT_r8<2, RegisterD> },
+	{ 0x53, 1, 8,  "BIT 2,E",    &CPU::BIT_r8<2, RegisterE> },
+	{ 0x54, 1, 8,  "BIT 2,H",    &CPU::BIT_r8<2, RegisterH> },
+	{ 0x55, 1, 8,  "BIT 2,L",    &CPU::BIT_r8<2, RegisterL> },
+	{ 0x56, 1, 16, "BIT 2,(HL)", &CPU::BIT_rp16<2, RegisterHL> },
+	{ 0x57, 1, 8,  "BIT 2,A",    &CPU::BIT_r8<2, RegisterA> },
+	{ 0x58, 1, 8,  "BIT 3,B",    &CPU::BIT_r8<3, RegisterB> },
+	{ 0x59, 1, 8,  "BIT 3,C",    &CPU::BIT_r8<3, RegisterC> },
+	{ 0x5A, 1, 8,  "BIT 3,D",    &CPU::BIT_r8<3, RegisterD> },
+	{ 0x5B, 1, 8,  "BIT 3,E",    &CPU::BIT_r8<3, RegisterE> },
+	{ 0x5C, 1, 8,  "BIT 3,H",    &CPU::BIT_r8<3, RegisterH> },
+	{ 0x5D, 1, 8,  "BIT 3,L",    &CPU::BIT_r8<3, RegisterL> },
+	{ 0x5E, 1, 16, "BIT 3,(HL)", &CPU::BIT_rp16<3, RegisterHL> },
+	{ 0x5F, 1, 8,  "BIT 3,A",    &CPU::BIT_r8<3, RegisterA> },
+	{ 0x60, 1, 8,  "BIT 4,B",    &CPU::BIT_r8<4, RegisterB> },
+	{ 0x61, 1, 8,  "BIT 4,C",    &CPU::BIT_r8<4, RegisterC> },
+	{ 0x62, 1, 8,  "BIT 4,D",    &CPU::BIT_r8<4, RegisterD> },
+	{ 0x63, 1, 8,  "BIT 4,E",    &CPU::BIT_r8<4, RegisterE> },
+	{ 0x64, 1, 8,  "BIT 4,H",    &CPU::BIT_r8<4, RegisterH> },
+	{ 0x65, 1, 8,  "BIT 4,L",    &CPU::BIT_r8<4, RegisterL> },
+	{ 0x66, 1, 16, "BIT 4,(HL)", &CPU::BIT_rp16<4, RegisterHL> },
+	{ 0x67, 1, 8,  "BIT 4,A",    &CPU::BIT_r8<4, RegisterA> },
+	{ 0x68, 1, 8,  "BIT 5,B",    &CPU::BIT_r8<5, RegisterB> },
+	{ 0x69, 1, 8,  "BIT 5,C",    &CPU::BIT_r8<5, RegisterC> },
+	{ 0x6A, 1, 8,  "BIT 5,D",    &CPU::BIT_r8<5, RegisterD> },
+	{ 0x6B, 1, 8,  "BIT 5,E",    &CPU::BIT_r8<5, RegisterE> },
+	{ 0x6C, 1, 8,  "BIT 5,H",    &CPU::BIT_r8<5, RegisterH> },
+	{ 0x6D, 1, 8,  "BIT 5,L",    &CPU::BIT_r8<5, RegisterL> },
+	{ 0x6E, 1, 16, "BIT 5,(HL)", &CPU::BIT_rp16<5, RegisterHL> },
+	{ 0x6F, 1, 8,  "BIT 5,A",    &CPU::BIT_r8<5, RegisterA> },
+	{ 0x70, 1, 8,  "BIT 6,B",    &CPU::BIT_r8<6, RegisterB> },
+	{ 0x71, 1, 8,  "BIT 6,C",    &CPU::BIT_r8<6, RegisterC> },
+	{ 0x72, 1, 8,  "BIT 6,D",    &CPU::BIT_r8<6, RegisterD> },
+	{ 0x73, 1, 8,  "BIT 6,E",    &CPU::BIT_r8<6, RegisterE> },
+	{ 0x74, 1, 8,  "BIT 6,H",    &CPU::BIT_r8<6, RegisterH> },
+	{ 0x75, 1, 8,  "BIT 6,L",    &CPU::BIT_r8<6, RegisterL> },
+	{ 0x76, 1, 16, "BIT 6,(HL)", &CPU::BIT_rp16<6, RegisterHL> },
+	{ 0x77, 1, 8,  "BIT 6,A",    &CPU::BIT_r8<6, RegisterA> },
+	{ 0x78, 1, 8,  "BIT 7,B",    &CPU::BIT_r8<7, RegisterB> },
+	{ 0x79, 1, 8,  "BIT 7,C",    &CPU::BIT_r8<7, RegisterC> },
+	{ 0x7A, 1, 8,  "BIT 7,D",    &CPU::BIT_r8<7, RegisterD> },
+	{ 0x7B, 1, 8,  "BIT 7,E",    &CPU::BIT_r8<7, RegisterE> },
+	{ 0x7C, 1, 8,  "BIT 7,H",    &CPU::BIT_r8<7, RegisterH> },
+	{ 0x7D, 1, 8,  "BIT 7,L",    &CPU::BIT_r8<7, RegisterL> },
+	{ 0x7E, 1, 16, "BIT 7,(HL)", &CPU::BIT_rp16<7, RegisterHL> },
+	{ 0x7F, 1, 8,  "BIT 7,A",    &CPU::BIT_r8<7, RegisterA> },
+	{ 0x80, 1, 8,  "RES 0,B",    &CPU::RES_r8<0, RegisterB> },
+	{ 0x81, 1, 8,  "RES 0,C",    &CPU::RES_r8<0, RegisterC> },
+	{ 0x82, 1, 8,  "RES 0,D",    &CPU::RES_r8<0, RegisterD> },
+	{ 0x83, 1, 8,  "RES 0,E",    &CPU::RES_r8<0, RegisterE> },
+	{ 0x84, 1, 8,  "RES 0,H",    &CPU::RES_r8<0, RegisterH> },
+	{ 0x85, 1, 8,  "RES 0,L",    &CPU::RES_r8<0, RegisterL> },
+	{ 0x86, 1, 16, "RES 0,(HL)", &CPU::RES_rp16<0, RegisterHL> },
+	{ 0x87, 1, 8,  "RES 0,A",    &CPU::RES_r8<0, RegisterA> },
+	{ 0x88, 1, 8,  "RES 1,B",    &CPU::RES_r8<1, RegisterB> },
+	{ 0x89, 1, 8,  "RES 1,C",    &CPU::RES_r8<1, RegisterC> },
+	{ 0x8A, 1, 8,  "RES 1,D",    &CPU::RES_r8<1, RegisterD> },
+	{ 0x8B, 1, 8,  "RES 1,E",    &CPU::RES_r8<1, RegisterE> },
+	{ 0x8C, 1, 8,  "RES 1,H",    &CPU::RES_r8<1, RegisterH> },
+	{ 0x8D, 1, 8,  "RES 1,L",    &CPU::RES_r8<1, RegisterL> },
+	{ 0x8E, 1, 16, "RES 1,(HL)", &CPU::RES_rp16<1, RegisterHL> },
+	{ 0x8F, 1, 8,  "RES 1,A",    &CPU::RES_r8<1, RegisterA> },
+	{ 0x90, 1, 8,  "RES 2,B",    &CPU::RES_r8<2, RegisterB> },
+	{ 0x91, 1, 8,  "RES 2,C",    &CPU::RES_r8<2, RegisterC> },
+	{ 0x92, 1, 8,  "RES 2,D",    &CPU::RES_r8<2, RegisterD> },
+	{ 0x93, 1, 8,  "RES 2,E",    &CPU::RES_r8<2, RegisterE> },
+	{ 0x94, 1, 8,  "RES 2,H",    &CPU::RES_r8<2, RegisterH> },
+	{ 0x95, 1, 8,  "RES 2,L",    &CPU::RES_r8<2, RegisterL> },
+	{ 0x96, 1, 16, "RES 2,(HL)", &CPU::RES_rp16<2, RegisterHL> },
+	{ 0x97, 1, 8,  "RES 2,A",    &CPU::RES_r8<2, RegisterA> },
+	{ 0x98, 1, 8,  "RES 3,B",    &CPU::RES_r8<3, RegisterB> },
+	{ 0x99, 1, 8,  "RES 3,C",    &CPU::RES_r8<3, RegisterC> },
+	{ 0x9A, 1, 8,  "RES 3,D",    &CPU::RES_r8<3, RegisterD> },
+	{ 0x9B, 1, 8,  "RES 3,E",    &CPU::RES_r8<3, RegisterE> },
+	{ 0x9C, 1, 8,  "RES 3,H",    &CPU::RES_r8<3, RegisterH> },
+	{ 0x9D, 1, 8,  "RES 3,L",    &CPU::RES_r8<3, RegisterL> },
+	{ 0x9E, 1, 16, "RES 3,(HL)", &CPU::RES_rp16<3, RegisterHL> },
+	{ 0x9F, 1, 8,  "RES 3,A",    &CPU::RES_r8<3, RegisterA> },
+	{ 0xA0, 1, 8,  "RES 4,B",    &CPU::RES_r8<4, RegisterB> },
+	{ 0xA1, 1, 8,  "RES 4,C",    &CPU::RES_r8<4, RegisterC> },
+	{ 0xA2, 1, 8,  "RES 4,D",    &CPU::RES_r8<4, RegisterD> },
+	{ 0xA3, 1, 8,  "RES 4,E",    &CPU::RES_r8<4, RegisterE> },
+	{ 0xA4, 1, 8,  "RES 4,H",    &CPU::RES_r8<4, RegisterH> },
+	{ 0xA5, 1, 8,  "RES 4,L",    &CPU::RES_r8<4, RegisterL> },
+	{ 0xA6, 1, 16, "RES 4,(HL)", &CPU::RES_rp16<4, RegisterHL> },
+	{ 0xA7, 1, 8,  "RES 4,A",    &CPU::RES_r8<4, RegisterA> },
+	{ 0xA8, 1, 8,  "RES 5,B",    &CPU::RES_r8<5, RegisterB> },
+	{ 0xA9, 1, 8,  "RES 5,C",    &CPU::RES_r8<5, RegisterC> },
+	{ 0xAA, 1, 8,  "RES 5,D",    &CPU::RES_r8<5, RegisterD> },
+	{ 0xAB, 1, 8,  "RES 5,E",    &CPU::RES_r8<5, RegisterE> },
+	{ 0xAC, 1, 8,  "RES 5,H",    &CPU::RES_r8<5, RegisterH> },
+	{ 0xAD, 1, 8,  "RES 5,L",    &CPU::RES_r8<5, RegisterL> },
+	{ 0xAE, 1, 16, "RES 5,(HL)", &CPU::RES_rp16<5, RegisterHL> },
+	{ 0xAF, 1, 8,  "RES 5,A",    &CPU::RES_r8<5, RegisterA> },
+	{ 0xB0, 1, 8,  "RES 6,B",    &CPU::RES_r8<6, RegisterB> },
+	{ 0xB1, 1, 8,  "RES 6,C",    &CPU::RES_r8<6, RegisterC> },
+	{ 0xB2, 1, 8,  "RES 6,D",    &CPU::RES_r8<6, RegisterD> },
+	{ 0xB3, 1, 8,  "RES 6,E",    &CPU::RES_r8<6, RegisterE> },
+	{ 0xB4, 1, 8,  "RES 6,H",    &CPU::RES_r8<6, RegisterH> },
+	{ 0xB5, 1, 8,  "RES 6,L",    &CPU::RES_r8<6, RegisterL> },
+	{ 0xB6, 1, 16, "RES 6,(HL)", &CPU::RES_rp16<6, RegisterHL> },
+	{ 0xB7, 1, 8,  "RES 6,A",    &CPU::RES_r8<6, RegisterA> },
+	{ 0xB8, 1, 8,  "RES 7,B",    &CPU::RES_r8<7, RegisterB> },
+	{ 0xB9, 1, 8,  "RES 7,C",    &CPU::RES_r8<7, RegisterC> },
+	{ 0xBA, 1, 8,  "RES 7,D",    &CPU::RES_r8<7, RegisterD> },
+	{ 0xBB, 1, 8,  "RES 7,E",    &CPU::RES_r8<7, RegisterE> },
+	{ 0xBC, 1, 8,  "RES 7,H",    &CPU::RES_r8<7, RegisterH> },
+	{ 0xBD, 1, 8,  "RES 7,L",    &CPU::RES_r8<7, RegisterL> },
+	{ 0xBE, 1, 16, "RES 7,(HL)", &CPU::RES_rp16<7, RegisterHL> },
+	{ 0xBF, 1, 8,  "RES 7,A",    &CPU::RES_r8<7, RegisterA> },
+	{ 0xC0, 1, 8,  "SET 0,B",    &CPU::SET_r8<0, RegisterB> },
+	{ 0xC1, 1, 8,  "SET 0,C",    &CPU::SET_r8<0, RegisterC> },
+	{ 0xC2, 1, 8,  "SET 0,D",    &CPU::SET_r8<0, RegisterD> },
+	{ 0xC3, 1, 8,  "SET 0,E",    &CPU::SET_r8<0, RegisterE> },
+	{ 0xC4, 1, 8,  "SET 0,H",    &CPU::SET_r8<0, RegisterH> },
+	{ 0xC5, 1, 8,  "SET 0,L",    &CPU::SET_r8<0, RegisterL> },
+	{ 0xC6, 1, 16, "SET 0,(HL)", &CPU::SET_rp16<0, RegisterHL> },
+	{ 0xC7, 1, 8,  "SET 0,A",    &CPU::SET_r8<0, RegisterA> },
+	{ 0xC8, 1, 8,  "SET 1,B",    &CPU::SET_r8<1, RegisterB> },
+	{ 0xC9, 1, 8,  "SET 1,C",    &CPU::SET_r8<1, RegisterC> },
+	{ 0xCA, 1, 8,  "SET 1,D",    &CPU::SET_r8<1, RegisterD> },
+	{ 0xCB, 1, 8,  "SET 1,E",    &CPU::SET_r8<1, RegisterE> },
+	{ 0xCC, 1, 8,  "SET 1,H",    &CPU::SET_r8<1, RegisterH> },
+	{ 0xCD, 1, 8,  "SET 1,L",    &CPU::SET_r8<1, RegisterL> },
+	{ 0xCE, 1, 16, "SET 1,(HL)", &CPU::SET_rp16<1, RegisterHL> },
+	{ 0xCF, 1, 8,  "SET 1,A",    &CPU::SET_r8<1, RegisterA> },
+	{ 0xD0, 1, 8,  "SET 2,B",    &CPU::SET_r8<2, RegisterB> },
+	{ 0xD1, 1, 8,  "SET 2,C",    &CPU::SET_r8<2, RegisterC> },
+	{ 0xD2, 1, 8,  "SET 2,D",    &CPU::SET_r8<2, RegisterD> },
+	{ 0xD3, 1, 8,  "SET 2,E",    &CPU::SET_r8<2, RegisterE> },
+	{ 0xD4, 1, 8,  "SET 2,H",    &CPU::SET_r8<2, RegisterH> },
+	{ 0xD5, 1, 8,  "SET 2,L",    &CPU::SET_r8<2, RegisterL> },
+	{ 0xD6, 1, 16, "SET 2,(HL)", &CPU::SET_rp16<2, RegisterHL> },
+	{ 0xD7, 1, 8,  "SET 2,A",    &CPU::SET_r8<2, RegisterA> },
+	{ 0xD8, 1, 8,  "SET 3,B",    &CPU::SET_r8<3, RegisterB> },
+	{ 0xD9, 1, 8,  "SET 3,C",    &CPU::SET_r8<3, RegisterC> },
+	{ 0xDA, 1, 8,  "SET 3,D",    &CPU::SET_r8<3, RegisterD> },
+	{ 0xDB, 1, 8,  "SET 3,E",    &CPU::SET_r8<3, RegisterE> },
+	{ 0xDC, 1, 8,  "SET 3,H",    &CPU::SET_r8<3, RegisterH> },
+	{ 0xDD, 1, 8,  "SET 3,L",    &CPU::SET_r8<3, RegisterL> },
+	{ 0xDE, 1, 16, "SET 3,(HL)", &CPU::SET_rp16<3, RegisterHL> },
+	{ 0xDF, 1, 8,  "SET 3,A",    &CPU::SET_r8<3, RegisterA> },
+	{ 0xE0, 1, 8,  "SET 4,B",    &CPU::SET_r8<4, RegisterB> },
+	{ 0xE1, 1, 8,  "SET 4,C",    &CPU::SET_r8<4, RegisterC> },
+	{ 0xE2, 1, 8,  "SET 4,D",    &CPU::SET_r8<4, RegisterD> },
+	{ 0xE3, 1, 8,  "SET 4,E",    &CPU::SET_r8<4, RegisterE> },
+	{ 0xE4, 1, 8,  "SET 4,H",    &CPU::SET_r8<4, RegisterH> },
+	{ 0xE5, 1, 8,  "SET 4,L",    &CPU::SET_r8<4, RegisterL> },
+	{ 0xE6, 1, 16, "SET 4,(HL)", &CPU::SET_rp16<4, RegisterHL> },
+	{ 0xE7, 1, 8,  "SET 4,A",    &CPU::SET_r8<4, RegisterA> },
+	{ 0xE8, 1, 8,  "SET 5,B",    &CPU::SET_r8<5, RegisterB> },
+	{ 0xE9, 1, 8,  "SET 5,C",    &CPU::SET_r8<5, RegisterC> },
+	{ 0xEA, 1, 8,  "SET 5,D",    &CPU::SET_r8<5, RegisterD> },
+	{ 0xEB, 1, 8,  "SET 5,E",    &CPU::SET_r8<5, RegisterE> },
+	{ 0xEC, 1, 8,  "SET 5,H",    &CPU::SET_r8<5, RegisterH> },
+	{ 0xED, 1, 8,  "SET 5,L",    &CPU::SET_r8<5, RegisterL> },
+	{ 0xEE, 1, 16, "SET 5,(HL)", &CPU::SET_rp16<5, RegisterHL> },
+	{ 0xEF, 1, 8,  "SET 5,A",    &CPU::SET_r8<5, RegisterA> },
+	{ 0xF0, 1, 8,  "SET 6,B",    &CPU::SET_r8<6, RegisterB> },
+	{ 0xF1, 1, 8,  "SET 6,C",    &CPU::SET_r8<6, RegisterC> },
+	{ 0xF2, 1, 8,  "SET 6,D",    &CPU::SET_r8<6, RegisterD> },
+	{ 0xF3, 1, 8,  "SET 6,E",    &CPU::SET_r8<6, RegisterE> },
+	{ 0xF4, 1, 8,  "SET 6,H",    &CPU::SET_r8<6, RegisterH> },
+	{ 0xF5, 1, 8,  "SET 6,L",    &CPU::SET_r8<6, RegisterL> },
+	{ 0xF6, 1, 16, "SET 6,(HL)", &CPU::SET_rp16<6, RegisterHL> },
+	{ 0xF7, 1, 8,  "SET 6,A",    &CPU::SET_r8<6, RegisterA> },
+	{ 0xF8, 1, 8,  "SET 7,B",    &CPU::SET_r8<7, RegisterB> },
+	{ 0xF9, 1, 8,  "SET 7,C",    &CPU::SET_r8<7, RegisterC> },
+	{ 0xFA, 1, 8,  "SET 7,D",    &CPU::SET_r8<7, RegisterD> },
+	{ 0xFB, 1, 8,  "SET 7,E",    &CPU::SET_r8<7, RegisterE> },
+	{ 0xFC, 1, 8,  "SET 7,H",    &CPU::SET_r8<7, RegisterH> },
+	{ 0xFD, 1, 8,  "SET 7,L",    &CPU::SET_r8<7, RegisterL> },
+	{ 0xFE, 1, 16, "SET 7,(HL)", &CPU::SET_rp16<7, RegisterHL> },
+	{ 0xFF, 1, 8,  "SET 7,A",    &CPU::SET_r8<7, RegisterA> },
+};
+
+constexpr CPU::HandlerTable CPU::s_handlers = makeHandlerTable(s_definitions);
+constexpr CPU::HandlerTable CPU::s_cb_handlers = makeHandlerTable(s_cb_definitions);
+
+constexpr CPU::InstructionTable CPU::s_instructions = makeInstructionTable(s_definitions);
+constexpr CPU::InstructionTable CPU::s_cb_instructions = makeInstructionTable(s_cb_definitions);
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void CPU::fillInstructionsMap()
-{
-	using std::bind;
-
-	fillCBInstructionsMap();
-
-	std::vector<Instruction> instructions = {
-		{ 0x00, 1, 4,  "NOP",         bind(&CPU::NOP, this) },
-		{ 0x01, 3, 12, "LD BC,d16",   bind(&CPU::LD_r16_u16, this, RegisterBC) },
-		{ 0x02, 1, 8,  "LD (BC),A",   bind(&CPU::LD_rp16_r8, this, RegisterBC, RegisterA) },
-		{ 0x03, 1, 8,  "INC BC",      bind(&CPU::INC_r16, this, RegisterBC) },
-		{ 0x04, 1, 4,  "INC B",       bind(&CPU::INC_r8, this, RegisterB) },
-		{ 0x05, 1, 4,  "DEC B",       bind(&CPU::DEC_r8, this, RegisterB) },
-		{ 0x06, 2, 8,  "LD B,d8",     bind(&CPU::LD_r8_u8, this, RegisterB) },
-		{ 0x07, 1, 4,  "RLC A",       bind(&CPU::RLC_r8, this, RegisterA) },
-		{ 0x08, 3, 20, "LD (a16),SP", bind(&CPU::LD_up16_r16, this, RegisterSP) },
-		{ 0x09, 1, 8,  "ADD HL,BC",   bind(&CPU::ADD_r16_r16, this, RegisterHL, RegisterBC) },
-		{ 0x0A, 1, 8,  "LD A,(BC)",   bind(&CPU::LD_r8_rp16, this, RegisterA, RegisterBC) },
-		{ 0x0B, 1, 8,  "DEC BC",      bind(&CPU::DEC_r16, this, RegisterBC) },
-		{ 0x0C, 1, 4,  "INC C",       bind(&CPU::INC_r8, this, RegisterC) },
-		{ 0x0D, 1, 4,  "DEC C",       bind(&CPU::DEC_r8, this, RegisterC) },
-		{ 0x0E, 2, 8,  "LD C,d8",     bind(&CPU::LD_r8_u8, this, RegisterC) },
-		{ 0x0F, 1, 4,  "RRC A",       bind(&CPU::RRC_r8, this, RegisterA) },
-		{ 0x10, 2, 4,  "STOP",        bind(&CPU::STOP, this) },
-		{ 0x11, 3, 12, "LD DE,d16",   bind(&CPU::LD_r16_u16, this, RegisterDE) },
-		{ 0x12, 1, 8,  "LD (DE),A",   bind(&CPU::LD_rp16_r8, this, RegisterDE, RegisterA) },
-		{ 0x13, 1, 8,  "INC DE",      bind(&CPU::INC_r16, this, RegisterDE) },
-		{ 0x14, 1, 4,  "INC D",       bind(&CPU::INC_r8, this, RegisterD) },
-		{ 0x15, 1, 4,  "DEC D",       bind(&CPU::DEC_r8, this, RegisterD) },
-		{ 0x16, 2, 8,  "LD D,d8",     bind(&CPU::LD_r8_u8, this, RegisterD) },
-		{ 0x17, 1, 4,  "RL A",        bind(&CPU::RL_r8, this, RegisterA) },
-		{ 0x18, 2, 12, "JR r8",       bind(&CPU::JR_i8, this) },
-		{ 0x19, 1, 8,  "ADD HL,DE",   bind(&CPU::ADD_r16_r16, this, RegisterHL, RegisterDE) },
-		{ 0x1A, 1, 8,  "LD A,(DE)",   bind(&CPU::LD_r8_rp16, this, RegisterA, RegisterDE) },
-		{ 0x1B, 1, 8,  "DEC DE",      bind(&CPU::DEC_r16, this, RegisterDE) },
-		{ 0x1C, 1, 4,  "INC E",       bind(&CPU::INC_r8, this, RegisterE) },
-		{ 0x1D, 1, 4,  "DEC E",       bind(&CPU::DEC_r8, this, RegisterE) },
-		{ 0x1E, 2, 8,  "LD E,d8",     bind(&CPU::LD_r8_u8, this, RegisterE) },
-		{ 0x1F, 1, 4,  "RR A",        bind(&CPU::RR_r8, this, RegisterA) },
-		{ 0x20, 2, 8,  "JR NZ,r8",    bind(&CPU::JR_NC_i8, this, Zero) },
-		{ 0x21, 3, 12, "LD HL,d16",   bind(&CPU::LD_r16_u16, this, RegisterHL) },
-		{ 0x22, 1, 8,  "LD (HL+),A",  bind(&CPU::LDI_rp16_r8, this, RegisterHL, RegisterA) },
-		{ 0x23, 1, 8,  "INC HL",      bind(&CPU::INC_r16, this, RegisterHL) },
-		{ 0x24, 1, 4,  "INC H",       bind(&CPU::INC_r8, this, RegisterH) },
-		{ 0x25, 1, 4,  "DEC H",       bind(&CPU::DEC_r8, this, RegisterH) },
-		{ 0x26, 2, 8,  "LD H,d8",     bind(&CPU::LD_r8_u8, this, RegisterH) },
-		{ 0x27, 1, 4,  "DAA",         bind(&CPU::DAA, this) },
-		{ 0x28, 2, 8,  "JR Z,r8",     bind(&CPU::JR_C_i8, this, Zero) },
-		{ 0x29, 1, 8,  "ADD HL,HL",   bind(&CPU::ADD_r16_r16, this, RegisterHL, RegisterHL) },
-		{ 0x2A, 1, 8,  "LD A,(HL+)",  bind(&CPU::LDI_r8_rp16, this, RegisterA, RegisterHL) },
-		{ 0x2B, 1, 8,  "DEC HL",      bind(&CPU::DEC_r16, this, RegisterHL) },
-		{ 0x2C, 1, 4,  "INC L",       bind(&CPU::INC_r8, this, RegisterL) },
-		{ 0x2D, 1, 4,  "DEC L",       bind(&CPU::DEC_r8, this, RegisterL) },
-		{ 0x2E, 2, 8,  "LD L,d8",     bind(&CPU::LD_r8_u8, this, RegisterL) },
-		{ 0x2F, 1, 4,  "CPL",         bind(&CPU::CPL, this) },
-		{ 0x30, 2, 8,  "JR NC,r8",    bind(&CPU::JR_NC_i8, this, Carry) },
-		{ 0x31, 3, 12, "LD SP,d16",   bind(&CPU::LD_r16_u16, this, RegisterSP) },
-		{ 0x32, 1, 8,  "LD (HL-),A",  bind(&CPU::LDD_rp16_r8, this, RegisterHL, RegisterA) },
-		{ 0x33, 1, 8,  "INC SP",      bind(&CPU::INC_r16, this, RegisterSP) },
-		{ 0x34, 1, 12, "INC (HL)",    bind(&CPU::INC_rp16, this, RegisterHL) },
-		{ 0x35, 1, 12, "DEC (HL)",    bind(&CPU::DEC_rp16, this, RegisterHL) },
-		{ 0x36, 2, 12, "LD (HL),d8",  bind(&CPU::LD_rp16_u8, this, RegisterHL) },
-		{ 0x37, 1, 4,  "SCF",         bind(&CPU::SCF, this) },
-		{ 0x38, 2, 8,  "JR C,r8",     bind(&CPU::JR_C_i8, this, Carry) },
-		{ 0x39, 1, 8,  "ADD HL,SP",   bind(&CPU::ADD_r16_r16, this, RegisterHL, RegisterSP) },
-		{ 0x3A, 1, 8,  "LD A,(HL-)",  bind(&CPU::LDD_r8_rp16, this, RegisterA, RegisterHL) },
-		{ 0x3B, 1, 8,  "DEC SP",      bind(&CPU::DEC_r16, this, RegisterSP) },
-		{ 0x3C, 1, 4,  "INC A",       bind(&CPU::INC_r8, this, RegisterA) },
-		{ 0x3D, 1, 4,  "DEC A",       bind(&CPU::DEC_r8, this, RegisterA) },
-		{ 0x3E, 2, 8,  "LD A,d8",     bind(&CPU::LD_r8_u8, this, RegisterA) },
-		{ 0x3F, 1, 4,  "CCF",         bind(&CPU::CCF, this) },
-		{ 0x40, 1, 4,  "LD B,B",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterB) },
-		{ 0x41, 1, 4,  "LD B,C",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterC) },
-		{ 0x42, 1, 4,  "LD B,D",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterD) },
-		{ 0x43, 1, 4,  "LD B,E",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterE) },
-		{ 0x44, 1, 4,  "LD B,H",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterH) },
-		{ 0x45, 1, 4,  "LD B,L",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterL) },
-		{ 0x46, 1, 8,  "LD B,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterB, RegisterHL) },
-		{ 0x47, 1, 4,  "LD B,A",      bind(&CPU::LD_r8_r8, this, RegisterB, RegisterA) },
-		{ 0x48, 1, 4,  "LD C,B",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterB) },
-		{ 0x49, 1, 4,  "LD C,C",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterC) },
-		{ 0x4A, 1, 4,  "LD C,D",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterD) },
-		{ 0x4B, 1, 4,  "LD C,E",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterE) },
-		{ 0x4C, 1, 4,  "LD C,H",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterH) },
-		{ 0x4D, 1, 4,  "LD C,L",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterL) },
-		{ 0x4E, 1, 8,  "LD C,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterC, RegisterHL) },
-		{ 0x4F, 1, 4,  "LD C,A",      bind(&CPU::LD_r8_r8, this, RegisterC, RegisterA) },
-		{ 0x50, 1, 4,  "LD D,B",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterB) },
-		{ 0x51, 1, 4,  "LD D,C",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterC) },
-		{ 0x52, 1, 4,  "LD D,D",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterD) },
-		{ 0x53, 1, 4,  "LD D,E",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterE) },
-		{ 0x54, 1, 4,  "LD D,H",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterH) },
-		{ 0x55, 1, 4,  "LD D,L",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterL) },
-		{ 0x56, 1, 8,  "LD D,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterD, RegisterHL) },
-		{ 0x57, 1, 4,  "LD D,A",      bind(&CPU::LD_r8_r8, this, RegisterD, RegisterA) },
-		{ 0x58, 1, 4,  "LD E,B",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterB) },
-		{ 0x59, 1, 4,  "LD E,C",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterC) },
-		{ 0x5A, 1, 4,  "LD E,D",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterD) },
-		{ 0x5B, 1, 4,  "LD E,E",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterE) },
-		{ 0x5C, 1, 4,  "LD E,H",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterH) },
-		{ 0x5D, 1, 4,  "LD E,L",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterL) },
-		{ 0x5E, 1, 8,  "LD E,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterE, RegisterHL) },
-		{ 0x5F, 1, 4,  "LD E,A",      bind(&CPU::LD_r8_r8, this, RegisterE, RegisterA) },
-		{ 0x60, 1, 4,  "LD H,B",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterB) },
-		{ 0x61, 1, 4,  "LD H,C",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterC) },
-		{ 0x62, 1, 4,  "LD H,D",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterD) },
-		{ 0x63, 1, 4,  "LD H,E",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterE) },
-		{ 0x64, 1, 4,  "LD H,H",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterH) },
-		{ 0x65, 1, 4,  "LD H,L",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterL) },
-		{ 0x66, 1, 8,  "LD H,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterH, RegisterHL) },
-		{ 0x67, 1, 4,  "LD H,A",      bind(&CPU::LD_r8_r8, this, RegisterH, RegisterA) },
-		{ 0x68, 1, 4,  "LD L,B",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterB) },
-		{ 0x69, 1, 4,  "LD L,C",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterC) },
-		{ 0x6A, 1, 4,  "LD L,D",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterD) },
-		{ 0x6B, 1, 4,  "LD L,E",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterE) },
-		{ 0x6C, 1, 4,  "LD L,H",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterH) },
-		{ 0x6D, 1, 4,  "LD L,L",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterL) },
-		{ 0x6E, 1, 8,  "LD L,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterL, RegisterHL) },
-		{ 0x6F, 1, 4,  "LD L,A",      bind(&CPU::LD_r8_r8, this, RegisterL, RegisterA) },
-		{ 0x70, 1, 8,  "LD (HL),B",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterB) },
-		{ 0x71, 1, 8,  "LD (HL),C",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterC) },
-		{ 0x72, 1, 8,  "LD (HL),D",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterD) },
-		{ 0x73, 1, 8,  "LD (HL),E",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterE) },
-		{ 0x74, 1, 8,  "LD (HL),H",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterH) },
-		{ 0x75, 1, 8,  "LD (HL),L",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterL) },
-		{ 0x76, 1, 4,  "HALT",        bind(&CPU::HALT, this) },
-		{ 0x77, 1, 8,  "LD (HL),A",   bind(&CPU::LD_rp16_r8, this, RegisterHL, RegisterA) },
-		{ 0x78, 1, 4,  "LD A,B",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterB) },
-		{ 0x79, 1, 4,  "LD A,C",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterC) },
-		{ 0x7A, 1, 4,  "LD A,D",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterD) },
-		{ 0x7B, 1, 4,  "LD A,E",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterE) },
-		{ 0x7C, 1, 4,  "LD A,H",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterH) },
-		{ 0x7D, 1, 4,  "LD A,L",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterL) },
-		{ 0x7E, 1, 8,  "LD A,(HL)",   bind(&CPU::LD_r8_rp16, this, RegisterA, RegisterHL) },
-		{ 0x7F, 1, 4,  "LD A,A",      bind(&CPU::LD_r8_r8, this, RegisterA, RegisterA) },
-		{ 0x80, 1, 4,  "ADD A,B",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterB) },
-		{ 0x81, 1, 4,  "ADD A,C",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterC) },
-		{ 0x82, 1, 4,  "ADD A,D",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterD) },
-		{ 0x83, 1, 4,  "ADD A,E",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterE) },
-		{ 0x84, 1, 4,  "ADD A,H",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterH) },
-		{ 0x85, 1, 4,  "ADD A,L",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterL) },
-		{ 0x86, 1, 8,  "ADD A,(HL)",  bind(&CPU::ADD_r8_rp16, this, RegisterA, RegisterHL) },
-		{ 0x87, 1, 4,  "ADD A,A",     bind(&CPU::ADD_r8_r8, this, RegisterA, RegisterA) },
-		{ 0x88, 1, 4,  "ADC A,B",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterB) },
-		{ 0x89, 1, 4,  "ADC A,C",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterC) },
-		{ 0x8A, 1, 4,  "ADC A,D",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterD) },
-		{ 0x8B, 1, 4,  "ADC A,E",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterE) },
-		{ 0x8C, 1, 4,  "ADC A,H",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterH) },
-		{ 0x8D, 1, 4,  "ADC A,L",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterL) },
-		{ 0x8E, 1, 8,  "ADC A,(HL)",  bind(&CPU::ADC_r8_rp16, this, RegisterA, RegisterHL) },
-		{ 0x8F, 1, 4,  "ADC A,A",     bind(&CPU::ADC_r8_r8, this, RegisterA, RegisterA) },
-		{ 0x90, 1, 4,  "SUB B",       bind(&CPU::SUB_r8, this, RegisterB) },
-		{ 0x91, 1, 4,  "SUB C",       bind(&CPU::SUB_r8, this, RegisterC) },
-		{ 0x92, 1, 4,  "SUB D",       bind(&CPU::SUB_r8, this, RegisterD) },
-		{ 0x93, 1, 4,  "SUB E",       bind(&CPU::SUB_r8, this, RegisterE) },
-		{ 0x94, 1, 4,  "SUB H",       bind(&CPU::SUB_r8, this, RegisterH) },
-		{ 0x95, 1, 4,  "SUB L",       bind(&CPU::SUB_r8, this, RegisterL) },
-		{ 0x96, 1, 8,  "SUB (HL)",    bind(&CPU::SUB_rp16, this, RegisterHL) },
-		{ 0x97, 1, 4,  "SUB A",       bind(&CPU::SUB_r8, this, RegisterA) },
-		{ 0x98, 1, 4,  "SBC A,B",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterB) },
-		{ 0x99, 1, 4,  "SBC A,C",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterC) },
-		{ 0x9A, 1, 4,  "SBC A,D",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterD) },
-		{ 0x9B, 1, 4,  "SBC A,E",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterE) },
-		{ 0x9C, 1, 4,  "SBC A,H",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterH) },
-		{ 0x9D, 1, 4,  "SBC A,L",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterL) },
-		{ 0x9E, 1, 8,  "SBC A,(HL)",  bind(&CPU::SBC_r8_rp16, this, RegisterA, RegisterHL) },
-		{ 0x9F, 1, 4,  "SBC A,A",     bind(&CPU::SBC_r8_r8, this, RegisterA, RegisterA) },
-		{ 0xA0, 1, 4,  "AND B",       bind(&CPU::AND_r8, this, RegisterB) },
-		{ 0xA1, 1, 4,  "AND C",       bind(&CPU::AND_r8, this, RegisterC) },
-		{ 0xA2, 1, 4,  "AND D",       bind(&CPU::AND_r8, this, RegisterD) },
-		{ 0xA3, 1, 4,  "AND E",       bind(&CPU::AND_r8, this, RegisterE) },
-		{ 0xA4, 1, 4,  "AND H",       bind(&CPU::AND_r8, this, RegisterH) },
-		{ 0xA5, 1, 4,  "AND L",       bind(&CPU::AND_r8, this, RegisterL) },
-		{ 0xA6, 1, 8,  "AND (HL)",    bind(&CPU::AND_rp16, this, RegisterHL) },
-		{ 0xA7, 1, 4,  "AND A",       bind(&CPU::AND_r8, this, RegisterA) },
-		{ 0xA8, 1, 4,  "XOR B",       bind(&CPU::XOR_r8, this, RegisterB) },
-		{ 0xA9, 1, 4,  "XOR C",       bind(&CPU::XOR_r8, this, RegisterC) },
-		{ 0xAA, 1, 4,  "XOR D",       bind(&CPU::XOR_r8, this, RegisterD) },
-		{ 0xAB, 1, 4,  "XOR E",       bind(&CPU::XOR_r8, this, RegisterE) },
-		{ 0xAC, 1, 4,  "XOR H",       bind(&CPU::XOR_r8, this, RegisterH) },
-		{ 0xAD, 1, 4,  "XOR L",       bind(&CPU::XOR_r8, this, RegisterL) },
-		{ 0xAE, 1, 8,  "XOR (HL)",    bind(&CPU::XOR_rp16, this, RegisterHL) },
-		{ 0xAF, 1, 4,  "XOR A",       bind(&CPU::XOR_r8, this, RegisterA) },
-		{ 0xB0, 1, 4,  "OR B",        bind(&CPU::OR_r8, this, RegisterB) },
-		{ 0xB1, 1, 4,  "OR C",        bind(&CPU::OR_r8, this, RegisterC) },
-		{ 0xB2, 1, 4,  "OR D",        bind(&CPU::OR_r8, this, RegisterD) },
-		{ 0xB3, 1, 4,  "OR E",        bind(&CPU::OR_r8, this, RegisterE) },
-		{ 0xB4, 1, 4,  "OR H",        bind(&CPU::OR_r8, this, RegisterH) },
-		{ 0xB5, 1, 4,  "OR L",        bind(&CPU::OR_r8, this, RegisterL) },
-		{ 0xB6, 1, 8,  "OR (HL)",     bind(&CPU::OR_rp16, this, RegisterHL) },
-		{ 0xB7, 1, 4,  "OR A",        bind(&CPU::OR_r8, this, RegisterA) },
-		{ 0xB8, 1, 4,  "CP B",        bind(&CPU::CP_r8, this, RegisterB) },
-		{ 0xB9, 1, 4,  "CP C",        bind(&CPU::CP_r8, this, RegisterC) },
-		{ 0xBA, 1, 4,  "CP D",        bind(&CPU::CP_r8, this, RegisterD) },
-		{ 0xBB, 1, 4,  "CP E",        bind(&CPU::CP_r8, this, RegisterE) },
-		{ 0xBC, 1, 4,  "CP H",        bind(&CPU::CP_r8, this, RegisterH) },
-		{ 0xBD, 1, 4,  "CP L",        bind(&CPU::CP_r8, this, RegisterL) },
-		{ 0xBE, 1, 8,  "CP (HL)",     bind(&CPU::CP_rp16, this, RegisterHL) },
-		{ 0xBF, 1, 4,  "CP A",        bind(&CPU::CP_r8, this, RegisterA) },
-		{ 0xC0, 1, 8,  "RET NZ",      bind(&CPU::RET_NC, this, Zero) },
-		{ 0xC1, 1, 12, "POP BC",      bind(&CPU::POP_r16, this, RegisterBC) },
-		{ 0xC2, 3, 12, "JP NZ,a16",   bind(&CPU::JP_NC_u16, this, Zero) },
-		{ 0xC3, 3, 16, "JP a16",      bind(&CPU::JP_u16, this) },
-		{ 0xC4, 3, 12, "CALL NZ,a16", bind(&CPU::CALL_NC_u16, this, Zero) },
-		{ 0xC5, 1, 16, "PUSH BC",     bind(&CPU::PUSH_r16, this, RegisterBC) },
-		{ 0xC6, 2, 8,  "ADD A,d8",    bind(&CPU::ADD_r8_u8, this, RegisterA) },
-		{ 0xC7, 1, 16, "RST 00",      bind(&CPU::RST, this, 0x00) },
-		{ 0xC8, 1, 8,  "RET Z",       bind(&CPU::RET_C, this, Zero) },
-		{ 0xC9, 1, 16, "RET",         bind(&CPU::RET, this) },
-		{ 0xCA, 3, 12, "JP Z,a16",    bind(&CPU::JP_C_u16, this, Zero) },
-		{ 0xCB, 1, 4,  "PREFIX CB",   bind(&CPU::execNextInstructionWithMap, this, m_cb_instruction_map) },
-		{ 0xCC, 3, 12, "CALL Z,a16",  bind(&CPU::CALL_C_u16, this, Zero) },
-		{ 0xCD, 3, 24, "CALL a16",    bind(&CPU::CALL_u16, this) },
-		{ 0xCE, 2, 8,  "ADC A,d8",    bind(&CPU::ADC_r8_u8, this, RegisterA) },
-		{ 0xCF, 1, 16, "RST 08",      bind(&CPU::RST, this, 0x08) },
-		{ 0xD0, 1, 8,  "RET NC",      bind(&CPU::RET_NC, this, Carry) },
-		{ 0xD1, 1, 12, "POP DE",      bind(&CPU::POP_r16, this, RegisterDE) },
-		{ 0xD2, 3, 12, "JP NC,a16",   bind(&CPU::JP_NC_u16, this, Carry) },
-		{ 0xD4, 3, 12, "CALL NC,a16", bind(&CPU::CALL_NC_u16, this, Carry) },
-		{ 0xD5, 1, 16, "PUSH DE",     bind(&CPU::PUSH_r16, this, RegisterDE) },
-		{ 0xD6, 2, 8,  "SUB d8",      bind(&CPU::SUB_u8, this) },
-		{ 0xD7, 1, 16, "RST 10",      bind(&CPU::RST, this, 0x10) },
-		{ 0xD8, 1, 8,  "RET C",       bind(&CPU::RET_C, this, Carry) },
-		{ 0xD9, 1, 16, "RETI",        bind(&CPU::RETI, this) },
-		{ 0xDA, 3, 12, "JP C,a16",    bind(&CPU::JP_C_u16, this, Carry) },
-		{ 0xDC, 3, 12, "CALL C,a16",  bind(&CPU::CALL_C_u16, this, Carry) },
-		{ 0xDE, 2, 8,  "SBC A,d8",    bind(&CPU::SBC_r8_u8, this, RegisterA) },
-		{ 0xDF, 1, 16, "RST 18",      bind(&CPU::RST, this, 0x18) },
-		{ 0xE0, 2, 12, "LDH (a8),A",  bind(&CPU::LDH_up8_r8, this, RegisterA) },
-		{ 0xE1, 1, 12, "POP HL",      bind(&CPU::POP_r16, this, RegisterHL) },
-		{ 0xE2, 2, 8,  "LD (C),A",    bind(&CPU::LDH_rp8_r8, this, RegisterC, RegisterA) },
-		{ 0xE5, 1, 16, "PUSH HL",     bind(&CPU::PUSH_r16, this, RegisterHL) },
-		{ 0xE6, 2, 8,  "AND d8",      bind(&CPU::AND_u8, this) },
-		{ 0xE7, 1, 16, "RST 20",      bind(&CPU::RST, this, 0x20) },
-		{ 0xE8, 2, 16, "ADD SP,r8",   bind(&CPU::ADD_r16_i8, this, RegisterHL) },
-		{ 0xE9, 1, 4,  "JP (HL)",     bind(&CPU::JP_r16, this, RegisterHL) },
-		{ 0xEA, 3, 16, "LD (a16),A",  bind(&CPU::LD_up16_r8, this, RegisterA) },
-		{ 0xEE, 2, 8,  "XOR d8",      bind(&CPU::XOR_u8, this) },
-		{ 0xEF, 1, 16, "RST 28",      bind(&CPU::RST, this, 0x28) },
-		{ 0xF0, 2, 12, "LDH A,(a8)",  bind(&CPU::LDH_r8_up8, this, RegisterA) },
-		{ 0xF1, 1, 12, "POP AF",      bind(&CPU::POP_r16, this, RegisterAF) },
-		{ 0xF2, 2, 8,  "LD A,(C)",    bind(&CPU::LDH_r8_rp8, this, RegisterA, RegisterC) },
-		{ 0xF3, 1, 4,  "DI",          bind(&CPU::DI, this) },
-		{ 0xF5, 1, 16, "PUSH AF",     bind(&CPU::PUSH_r16, this, RegisterAF) },
-		{ 0xF6, 2, 8,  "OR d8",       bind(&CPU::OR_u8, this) },
-		{ 0xF7, 1, 16, "RST 30",      bind(&CPU::RST, this, 0x30) },
-		{ 0xF8, 2, 12, "LD HL,SP+r8", bind(&CPU::LD_r16_r16i8, this, RegisterHL, RegisterSP) },
-		{ 0xF9, 1, 8,  "LD SP,HL",    bind(&CPU::LD_r16_r16, this, RegisterSP, RegisterHL) },
-		{ 0xFA, 3, 16, "LD A,(a16)",  bind(&CPU::LD_r8_up16, this, RegisterA) },
-		{ 0xFB, 1, 4,  "EI",          bind(&CPU::EI, this) },
-		{ 0xFE, 2, 8,  "CP d8",       bind(&CPU::CP_u8, this) },
-		{ 0xFF, 1, 16, "RST 38",      bind(&CPU::RST, this, 0x38) },
-	};
+template<u8... Ops>
+void CPU::superinstruction()
+{
+	static_assert(((s_handlers[Ops] != nullptr) && ...));
+	static_assert((0 + ... + (s_instructions[Ops].length - 1)) <= 2, "Immediates must fit in m_operand");
 
-	for (auto i : instructions)
-		m_instruction_map.emplace(i.op, i);
-}
-
-void CPU::fillCBInstructionsMap()
-{
-	using std::bind;
-
-	std::vector<Instruction> cb_instructions = {
-		{ 0x00, 1, 8,  "RLC B",      bind(&CPU::RLC_r8,    this, RegisterB) },
-		{ 0x01, 1, 8,  "RLC C",      bind(&CPU::RLC_r8,    this, RegisterC) },
-		{ 0x02, 1, 8,  "RLC D",      bind(&CPU::RLC_r8,    this, RegisterD) },
-		{ 0x03, 1, 8,  "RLC E",      bind(&CPU::RLC_r8,    this, RegisterE) },
-		{ 0x04, 1, 8,  "RLC H",      bind(&CPU::RLC_r8,    this, RegisterH) },
-		{ 0x05, 1, 8,  "RLC L",      bind(&CPU::RLC_r8,    this, RegisterL) },
-		{ 0x06, 1, 16, "RLC (HL)",   bind(&CPU::RLC_rp16,  this, RegisterHL) },
-		{ 0x07, 1, 8,  "RLC A",      bind(&CPU::RLC_r8,    this, RegisterA) },
-		{ 0x08, 1, 8,  "RRC B",      bind(&CPU::RRC_r8,    this, RegisterB) },
-		{ 0x09, 1, 8,  "RRC C",      bind(&CPU::RRC_r8,    this, RegisterC) },
-		{ 0x0A, 1, 8,  "RRC D",      bind(&CPU::RRC_r8,    this, RegisterD) },
-		{ 0x0B, 1, 8,  "RRC E",      bind(&CPU::RRC_r8,    this, RegisterE) },
-		{ 0x0C, 1, 8,  "RRC H",      bind(&CPU::RRC_r8,    this, RegisterH) },
-		{ 0x0D, 1, 8,  "RRC L",      bind(&CPU::RRC_r8,    this, RegisterL) },
-		{ 0x0E, 1, 16, "RRC (HL)",   bind(&CPU::RRC_rp16,  this, RegisterHL) },
-		{ 0x0F, 1, 8,  "RRC A",      bind(&CPU::RRC_r8,    this, RegisterA) },
-		{ 0x10, 1, 8,  "RL B",       bind(&CPU::RL_r8,     this, RegisterB) },
-		{ 0x11, 1, 8,  "RL C",       bind(&CPU::RL_r8,     this, RegisterC) },
-		{ 0x12, 1, 8,  "RL D",       bind(&CPU::RL_r8,     this, RegisterD) },
-		{ 0x13, 1, 8,  "RL E",       bind(&CPU::RL_r8,     this, RegisterE) },
-		{ 0x14, 1, 8,  "RL H",       bind(&CPU::RL_r8,     this, RegisterH) },
-		{ 0x15, 1, 8,  "RL L",       bind(&CPU::RL_r8,     this, RegisterL) },
-		{ 0x16, 1, 16, "RL (HL)",    bind(&CPU::RL_rp16,   this, RegisterHL) },
-		{ 0x17, 1, 8,  "RL A",       bind(&CPU::RL_r8,     this, RegisterA) },
-		{ 0x18, 1, 8,  "RR B",       bind(&CPU::RR_r8,     this, RegisterB) },
-		{ 0x19, 1, 8,  "RR C",       bind(&CPU::RR_r8,     this, RegisterC) },
-		{ 0x1A, 1, 8,  "RR D",       bind(&CPU::RR_r8,     this, RegisterD) },
-		{ 0x1B, 1, 8,  "RR E",       bind(&CPU::RR_r8,     this, RegisterE) },
-		{ 0x1C, 1, 8,  "RR H",       bind(&CPU::RR_r8,     this, RegisterH) },
-		{ 0x1D, 1, 8,  "RR L",       bind(&CPU::RR_r8,     this, RegisterL) },
-		{ 0x1E, 1, 16, "RR (HL)",    bind(&CPU::RR_rp16,   this, RegisterHL) },
-		{ 0x1F, 1, 8,  "RR A",       bind(&CPU::RR_r8,     this, RegisterA) },
-		{ 0x20, 1, 8,  "SLA B",      bind(&CPU::SLA_r8,    this, RegisterB) },
-		{ 0x21, 1, 8,  "SLA C",      bind(&CPU::SLA_r8,    this, RegisterC) },
-		{ 0x22, 1, 8,  "SLA D",      bind(&CPU::SLA_r8,    this, RegisterD) },
-		{ 0x23, 1, 8,  "SLA E",      bind(&CPU::SLA_r8,    this, RegisterE) },
-		{ 0x24, 1, 8,  "SLA H",      bind(&CPU::SLA_r8,    this, RegisterH) },
-		{ 0x25, 1, 8,  "SLA L",      bind(&CPU::SLA_r8,    this, RegisterL) },
-		{ 0x26, 1, 16, "SLA (HL)",   bind(&CPU::SLA_rp16,  this, RegisterHL) },
-		{ 0x27, 1, 8,  "SLA A",      bind(&CPU::SLA_r8,    this, RegisterA) },
-		{ 0x28, 1, 8,  "SRA B",      bind(&CPU::SRA_r8,    this, RegisterB) },
-		{ 0x29, 1, 8,  "SRA C",      bind(&CPU::SRA_r8,    this, RegisterC) },
-		{ 0x2A, 1, 8,  "SRA D",      bind(&CPU::SRA_r8,    this, RegisterD) },
-		{ 0x2B, 1, 8,  "SRA E",      bind(&CPU::SRA_r8,    this, RegisterE) },
-		{ 0x2C, 1, 8,  "SRA H",      bind(&CPU::SRA_r8,    this, RegisterH) },
-		{ 0x2D, 1, 8,  "SRA L",      bind(&CPU::SRA_r8,    this, RegisterL) },
-		{ 0x2E, 1, 16, "SRA (HL)",   bind(&CPU::SRA_rp16,  this, RegisterHL) },
-		{ 0x2F, 1, 8,  "SRA A",      bind(&CPU::SRA_r8,    this, RegisterA) },
-		{ 0x30, 1, 8,  "SWAP B",     bind(&CPU::SWAP_r8,   this, RegisterB) },
-		{ 0x31, 1, 8,  "SWAP C",     bind(&CPU::SWAP_r8,   this, RegisterC) },
-		{ 0x32, 1, 8,  "SWAP D",     bind(&CPU::SWAP_r8,   this, RegisterD) },
-		{ 0x33, 1, 8,  "SWAP E",     bind(&CPU::SWAP_r8,   this, RegisterE) },
-		{ 0x34, 1, 8,  "SWAP H",     bind(&CPU::SWAP_r8,   this, RegisterH) },
-		{ 0x35, 1, 8,  "SWAP L",     bind(&CPU::SWAP_r8,   this, RegisterL) },
-		{ 0x36, 1, 16, "SWAP (HL)",  bind(&CPU::SWAP_rp16, this, RegisterHL) },
-		{ 0x37, 1, 8,  "SWAP A",     bind(&CPU::SWAP_r8,   this, RegisterA) },
-		{ 0x38, 1, 8,  "SRL B",      bind(&CPU::SRL_r8,    this, RegisterB) },
-		{ 0x39, 1, 8,  "SRL C",      bind(&CPU::SRL_r8,    this, RegisterC) },
-		{ 0x3A, 1, 8,  "SRL D",      bind(&CPU::SRL_r8,    this, RegisterD) },
-		{ 0x3B, 1, 8,  "SRL E",      bind(&CPU::SRL_r8,    this, RegisterE) },
-		{ 0x3C, 1, 8,  "SRL H",      bind(&CPU::SRL_r8,    this, RegisterH) },
-		{ 0x3D, 1, 8,  "SRL L",      bind(&CPU::SRL_r8,    this, RegisterL) },
-		{ 0x3E, 1, 16, "SRL (HL)",   bind(&CPU::SRL_rp16,  this, RegisterHL) },
-		{ 0x3F, 1, 8,  "SRL A",      bind(&CPU::SRL_r8,    this, RegisterA) },
-		{ 0x40, 1, 8,  "BIT 0,B",    bind(&CPU::BIT_r8,    this, 0, RegisterB) },
-		{ 0x41, 1, 8,  "BIT 0,C",    bind(&CPU::BIT_r8,    this, 0, RegisterC) },
-		{ 0x42, 1, 8,  "BIT 0,D",    bind(&CPU::BIT_r8,    this, 0, RegisterD) },
-		{ 0x43, 1, 8,  "BIT 0,E",    bind(&CPU::BIT_r8,    this, 0, RegisterE) },
-		{ 0x44, 1, 8,  "BIT 0,H",    bind(&CPU::BIT_r8,    this, 0, RegisterH) },
-		{ 0x45, 1, 8,  "BIT 0,L",    bind(&CPU::BIT_r8,    this, 0, RegisterL) },
-		{ 0x46, 1, 16, "BIT 0,(HL)", bind(&CPU::BIT_rp16,  this, 0, RegisterHL) },
-		{ 0x47, 1, 8,  "BIT 0,A",    bind(&CPU::BIT_r8,    this, 0, RegisterA) },
-		{ 0x48, 1, 8,  "BIT 1,B",    bind(&CPU::BIT_r8,    this, 1, RegisterB) },
-		{ 0x49, 1, 8,  "BIT 1,C",    bind(&CPU::BIT_r8,    this, 1, RegisterC) },
-		{ 0x4A, 1, 8,  "BIT 1,D",    bind(&CPU::BIT_r8,    this, 1, RegisterD) },
-		{ 0x4B, 1, 8,  "BIT 1,E",    bind(&CPU::BIT_r8,    this, 1, RegisterE) },
-		{ 0x4C, 1, 8,  "BIT 1,H",    bind(&CPU::BIT_r8,    this, 1, RegisterH) },
-		{ 0x4D, 1, 8,  "BIT 1,L",    bind(&CPU::BIT_r8,    this, 1, RegisterL) },
-		{ 0x4E, 1, 16, "BIT 1,(HL)", bind(&CPU::BIT_rp16,  this, 1, RegisterHL) },
-		{ 0x4F, 1, 8,  "BIT 1,A",    bind(&CPU::BIT_r8,    this, 1, RegisterA) },
-		{ 0x50, 1, 8,  "BIT 2,B",    bind(&CPU::BIT_r8,    this, 2, RegisterB) },
-		{ 0x51, 1, 8,  "BIT 2,C",    bind(&CPU::BIT_r8,    this, 2, RegisterC) },
-		{ 0x52, 1, 8,  "BIT 2,D",    bind(&CPU::BIT_r8,    this, 2, RegisterD) },
-		{ 0x53, 1, 8,  "BIT 2,E",    bind(&CPU::BIT_r8,    this, 2, RegisterE) },
-		{ 0x54, 1, 8,  "BIT 2,H",    bind(&CPU::BIT_r8,    this, 2, RegisterH) },
-		{ 0x55, 1, 8,  "BIT 2,L",    bind(&CPU::BIT_r8,    this, 2, RegisterL) },
-		{ 0x56, 1, 16, "BIT 2,(HL)", bind(&CPU::BIT_rp16,  this, 2, RegisterHL) },
-		{ 0x57, 1, 8,  "BIT 2,A",    bind(&CPU::BIT_r8,    this, 2, RegisterA) },
-		{ 0x58, 1, 8,  "BIT 3,B",    bind(&CPU::BIT_r8,    this, 3, RegisterB) },
-		{ 0x59, 1, 8,  "BIT 3,C",    bind(&CPU::BIT_r8,    this, 3, RegisterC) },
-		{ 0x5A, 1, 8,  "BIT 3,D",    bind(&CPU::BIT_r8,    this, 3, RegisterD) },
-		{ 0x5B, 1, 8,  "BIT 3,E",    bind(&CPU::BIT_r8,    this, 3, RegisterE) },
-		{ 0x5C, 1, 8,  "BIT 3,H",    bind(&CPU::BIT_r8,    this, 3, RegisterH) },
-		{ 0x5D, 1, 8,  "BIT 3,L",    bind(&CPU::BIT_r8,    this, 3, RegisterL) },
-		{ 0x5E, 1, 16, "BIT 3,(HL)", bind(&CPU::BIT_rp16,  this, 3, RegisterHL) },
-		{ 0x5F, 1, 8,  "BIT 3,A",    bind(&CPU::BIT_r8,    this, 3, RegisterA) },
-		{ 0x60, 1, 8,  "BIT 4,B",    bind(&CPU::BIT_r8,    this, 4, RegisterB) },
-		{ 0x61, 1, 8,  "BIT 4,C",    bind(&CPU::BIT_r8,    this, 4, RegisterC) },
-		{ 0x62, 1, 8,  "BIT 4,D",    bind(&CPU::BIT_r8,    this, 4, RegisterD) },
-		{ 0x63, 1, 8,  "BIT 4,E",    bind(&CPU::BIT_r8,    this, 4, RegisterE) },
-		{ 0x64, 1, 8,  "BIT 4,H",    bind(&CPU::BIT_r8,    this, 4, RegisterH) },
-		{ 0x65, 1, 8,  "BIT 4,L",    bind(&CPU::BIT_r8,    this, 4, RegisterL) },
-		{ 0x66, 1, 16, "BIT 4,(HL)", bind(&CPU::BIT_rp16,  this, 4, RegisterHL) },
-		{ 0x67, 1, 8,  "BIT 4,A",    bind(&CPU::BIT_r8,    this, 4, RegisterA) },
-		{ 0x68, 1, 8,  "BIT 5,B",    bind(&CPU::BIT_r8,    this, 5, RegisterB) },
-		{ 0x69, 1, 8,  "BIT 5,C",    bind(&CPU::BIT_r8,    this, 5, RegisterC) },
-		{ 0x6A, 1, 8,  "BIT 5,D",    bind(&CPU::BIT_r8,    this, 5, RegisterD) },
-		{ 0x6B, 1, 8,  "BIT 5,E",    bind(&CPU::BIT_r8,    this, 5, RegisterE) },
-		{ 0x6C, 1, 8,  "BIT 5,H",    bind(&CPU::BIT_r8,    this, 5, RegisterH) },
-		{ 0x6D, 1, 8,  "BIT 5,L",    bind(&CPU::BIT_r8,    this, 5, RegisterL) },
-		{ 0x6E, 1, 16, "BIT 5,(HL)", bind(&CPU::BIT_rp16,  this, 5, RegisterHL) },
-		{ 0x6F, 1, 8,  "BIT 5,A",    bind(&CPU::BIT_r8,    this, 5, RegisterA) },
-		{ 0x70, 1, 8,  "BIT 6,B",    bind(&CPU::BIT_r8,    this, 6, RegisterB) },
-		{ 0x71, 1, 8,  "BIT 6,C",    bind(&CPU::BIT_r8,    this, 6, RegisterC) },
-		{ 0x72, 1, 8,  "BIT 6,D",    bind(&CPU::BIT_r8,    this, 6, RegisterD) },
-		{ 0x73, 1, 8,  "BIT 6,E",    bind(&CPU::BIT_r8,    this, 6, RegisterE) },
-		{ 0x74, 1, 8,  "BIT 6,H",    bind(&CPU::BIT_r8,    this, 6, RegisterH) },
-		{ 0x75, 1, 8,  "BIT 6,L",    bind(&CPU::BIT_r8,    this, 6, RegisterL) },
-		{ 0x76, 1, 16, "BIT 6,(HL)", bind(&CPU::BIT_rp16,  this, 6, RegisterHL) },
-		{ 0x77, 1, 8,  "BIT 6,A",    bind(&CPU::BIT_r8,    this, 6, RegisterA) },
-		{ 0x78, 1, 8,  "BIT 7,B",    bind(&CPU::BIT_r8,    this, 7, RegisterB) },
-		{ 0x79, 1, 8,  "BIT 7,C",    bind(&CPU::BIT_r8,    this, 7, RegisterC) },
-		{ 0x7A, 1, 8,  "BIT 7,D",    bind(&CPU::BIT_r8,    this, 7, RegisterD) },
-		{ 0x7B, 1, 8,  "BIT 7,E",    bind(&CPU::BIT_r8,    this, 7, RegisterE) },
-		{ 0x7C, 1, 8,  "BIT 7,H",    bind(&CPU::BIT_r8,    this, 7, RegisterH) },
-		{ 0x7D, 1, 8,  "BIT 7,L",    bind(&CPU::BIT_r8,    this, 7, RegisterL) },
-		{ 0x7E, 1, 16, "BIT 7,(HL)", bind(&CPU::BIT_rp16,  this, 7, RegisterHL) },
-		{ 0x7F, 1, 8,  "BIT 7,A",    bind(&CPU::BIT_r8,    this, 7, RegisterA) },
-		{ 0x80, 1, 8,  "RES 0,B",    bind(&CPU::RES_r8,    this, 0, RegisterB) },
-		{ 0x81, 1, 8,  "RES 0,C",    bind(&CPU::RES_r8,    this, 0, RegisterC) },
-		{ 0x82, 1, 8,  "RES 0,D",    bind(&CPU::RES_r8,    this, 0, RegisterD) },
-		{ 0x83, 1, 8,  "RES 0,E",    bind(&CPU::RES_r8,    this, 0, RegisterE) },
-		{ 0x84, 1, 8,  "RES 0,H",    bind(&CPU::RES_r8,    this, 0, RegisterH) },
-		{ 0x85, 1, 8,  "RES 0,L",    bind(&CPU::RES_r8,    this, 0, RegisterL) },
-		{ 0x86, 1, 16, "RES 0,(HL)", bind(&CPU::RES_rp16,  this, 0, RegisterHL) },
-		{ 0x87, 1, 8,  "RES 0,A",    bind(&CPU::RES_r8,    this, 0, RegisterA) },
-		{ 0x88, 1, 8,  "RES 1,B",    bind(&CPU::RES_r8,    this, 1, RegisterB) },
-		{ 0x89, 1, 8,  "RES 1,C",    bind(&CPU::RES_r8,    this, 1, RegisterC) },
-		{ 0x8A, 1, 8,  "RES 1,D",    bind(&CPU::RES_r8,    this, 1, RegisterD) },
-		{ 0x8B, 1, 8,  "RES 1,E",    bind(&CPU::RES_r8,    this, 1, RegisterE) },
-		{ 0x8C, 1, 8,  "RES 1,H",    bind(&CPU::RES_r8,    this, 1, RegisterH) },
-		{ 0x8D, 1, 8,  "RES 1,L",    bind(&CPU::RES_r8,    this, 1, RegisterL) },
-		{ 0x8E, 1, 16, "RES 1,(HL)", bind(&CPU::RES_rp16,  this, 1, RegisterHL) },
-		{ 0x8F, 1, 8,  "RES 1,A",    bind(&CPU::RES_r8,    this, 1, RegisterA) },
-		{ 0x90, 1, 8,  "RES 2,B",    bind(&CPU::RES_r8,    this, 2, RegisterB) },
-		{ 0x91, 1, 8,  "RES 2,C",    bind(&CPU::RES_r8,    this, 2, RegisterC) },
-		{ 0x92, 1, 8,  "RES 2,D",    bind(&CPU::RES_r8,    this, 2, RegisterD) },
-		{ 0x93, 1, 8,  "RES 2,E",    bind(&CPU::RES_r8,    this, 2, RegisterE) },
-		{ 0x94, 1, 8,  "RES 2,H",    bind(&CPU::RES_r8,    this, 2, RegisterH) },
-		{ 0x95, 1, 8,  "RES 2,L",    bind(&CPU::RES_r8,    this, 2, RegisterL) },
-		{ 0x96, 1, 16, "RES 2,(HL)", bind(&CPU::RES_rp16,  this, 2, RegisterHL) },
-		{ 0x97, 1, 8,  "RES 2,A",    bind(&CPU::RES_r8,    this, 2, RegisterA) },
-		{ 0x98, 1, 8,  "RES 3,B",    bind(&CPU::RES_r8,    this, 3, RegisterB) },
-		{ 0x99, 1, 8,  "RES 3,C",    bind(&CPU::RES_r8,    this, 3, RegisterC) },
-		{ 0x9A, 1, 8,  "RES 3,D",    bind(&CPU::RES_r8,    this, 3, RegisterD) },
-		{ 0x9B, 1, 8,  "RES 3,E",    bind(&CPU::RES_r8,    this, 3, RegisterE) },
-		{ 0x9C, 1, 8,  "RES 3,H",    bind(&CPU::RES_r8,    this, 3, RegisterH) },
-		{ 0x9D, 1, 8,  "RES 3,L",    bind(&CPU::RES_r8,    this, 3, RegisterL) },
-		{ 0x9E, 1, 16, "RES 3,(HL)", bind(&CPU::RES_rp16,  this, 3, RegisterHL) },
-		{ 0x9F, 1, 8,  "RES 3,A",    bind(&CPU::RES_r8,    this, 3, RegisterA) },
-		{ 0xA0, 1, 8,  "RES 4,B",    bind(&CPU::RES_r8,    this, 4, RegisterB) },
-		{ 0xA1, 1, 8,  "RES 4,C",    bind(&CPU::RES_r8,    this, 4, RegisterC) },
-		{ 0xA2, 1, 8,  "RES 4,D",    bind(&CPU::RES_r8,    this, 4, RegisterD) },
-		{ 0xA3, 1, 8,  "RES 4,E",    bind(&CPU::RES_r8,    this, 4, RegisterE) },
-		{ 0xA4, 1, 8,  "RES 4,H",    bind(&CPU::RES_r8,    this, 4, RegisterH) },
-		{ 0xA5, 1, 8,  "RES 4,L",    bind(&CPU::RES_r8,    this, 4, RegisterL) },
-		{ 0xA6, 1, 16, "RES 4,(HL)", bind(&CPU::RES_rp16,  this, 4, RegisterHL) },
-		{ 0xA7, 1, 8,  "RES 4,A",    bind(&CPU::RES_r8,    this, 4, RegisterA) },
-		{ 0xA8, 1, 8,  "RES 5,B",    bind(&CPU::RES_r8,    this, 5, RegisterB) },
-		{ 0xA9, 1, 8,  "RES 5,C",    bind(&CPU::RES_r8,    this, 5, RegisterC) },
-		{ 0xAA, 1, 8,  "RES 5,D",    bind(&CPU::RES_r8,    this, 5, RegisterD) },
-		{ 0xAB, 1, 8,  "RES 5,E",    bind(&CPU::RES_r8,    this, 5, RegisterE) },
-		{ 0xAC, 1, 8,  "RES 5,H",    bind(&CPU::RES_r8,    this, 5, RegisterH) },
-		{ 0xAD, 1, 8,  "RES 5,L",    bind(&CPU::RES_r8,    this, 5, RegisterL) },
-		{ 0xAE, 1, 16, "RES 5,(HL)", bind(&CPU::RES_rp16,  this, 5, RegisterHL) },
-		{ 0xAF, 1, 8,  "RES 5,A",    bind(&CPU::RES_r8,    this, 5, RegisterA) },
-		{ 0xB0, 1, 8,  "RES 6,B",    bind(&CPU::RES_r8,    this, 6, RegisterB) },
-		{ 0xB1, 1, 8,  "RES 6,C",    bind(&CPU::RES_r8,    this, 6, RegisterC) },
-		{ 0xB2, 1, 8,  "RES 6,D",    bind(&CPU::RES_r8,    this, 6, RegisterD) },
-		{ 0xB3, 1, 8,  "RES 6,E",    bind(&CPU::RES_r8,    this, 6, RegisterE) },
-		{ 0xB4, 1, 8,  "RES 6,H",    bind(&CPU::RES_r8,    this, 6, RegisterH) },
-		{ 0xB5, 1, 8,  "RES 6,L",    bind(&CPU::RES_r8,    this, 6, RegisterL) },
-		{ 0xB6, 1, 16, "RES 6,(HL)", bind(&CPU::RES_rp16,  this, 6, RegisterHL) },
-		{ 0xB7, 1, 8,  "RES 6,A",    bind(&CPU::RES_r8,    this, 6, RegisterA) },
-		{ 0xB8, 1, 8,  "RES 7,B",    bind(&CPU::RES_r8,    this, 7, RegisterB) },
-		{ 0xB9, 1, 8,  "RES 7,C",    bind(&CPU::RES_r8,    this, 7, RegisterC) },
-		{ 0xBA, 1, 8,  "RES 7,D",    bind(&CPU::RES_r8,    this, 7, RegisterD) },
-		{ 0xBB, 1, 8,  "RES 7,E",    bind(&CPU::RES_r8,    this, 7, RegisterE) },
-		{ 0xBC, 1, 8,  "RES 7,H",    bind(&CPU::RES_r8,    this, 7, RegisterH) },
-		{ 0xBD, 1, 8,  "RES 7,L",    bind(&CPU::RES_r8,    this, 7, RegisterL) },
-		{ 0xBE, 1, 16, "RES 7,(HL)", bind(&CPU::RES_rp16,  this, 7, RegisterHL) },
-		{ 0xBF, 1, 8,  "RES 7,A",    bind(&CPU::RES_r8,    this, 7, RegisterA) },
-		{ 0xC0, 1, 8,  "SET 0,B",    bind(&CPU::SET_r8,    this, 0, RegisterB) },
-		{ 0xC1, 1, 8,  "SET 0,C",    bind(&CPU::SET_r8,    this, 0, RegisterC) },
-		{ 0xC2, 1, 8,  "SET 0,D",    bind(&CPU::SET_r8,    this, 0, RegisterD) },
-		{ 0xC3, 1, 8,  "SET 0,E",    bind(&CPU::SET_r8,    this, 0, RegisterE) },
-		{ 0xC4, 1, 8,  "SET 0,H",    bind(&CPU::SET_r8,    this, 0, RegisterH) },
-		{ 0xC5, 1, 8,  "SET 0,L",    bind(&CPU::SET_r8,    this, 0, RegisterL) },
-		{ 0xC6, 1, 16, "SET 0,(HL)", bind(&CPU::SET_rp16,  this, 0, RegisterHL) },
-		{ 0xC7, 1, 8,  "SET 0,A",    bind(&CPU::SET_r8,    this, 0, RegisterA) },
-		{ 0xC8, 1, 8,  "SET 1,B",    bind(&CPU::SET_r8,    this, 1, RegisterB) },
-		{ 0xC9, 1, 8,  "SET 1,C",    bind(&CPU::SET_r8,    this, 1, RegisterC) },
-		{ 0xCA, 1, 8,  "SET 1,D",    bind(&CPU::SET_r8,    this, 1, RegisterD) },
-		{ 0xCB, 1, 8,  "SET 1,E",    bind(&CPU::SET_r8,    this, 1, RegisterE) },
-		{ 0xCC, 1, 8,  "SET 1,H",    bind(&CPU::SET_r8,    this, 1, RegisterH) },
-		{ 0xCD, 1, 8,  "SET 1,L",    bind(&CPU::SET_r8,    this, 1, RegisterL) },
-		{ 0xCE, 1, 16, "SET 1,(HL)", bind(&CPU::SET_rp16,  this, 1, RegisterHL) },
-		{ 0xCF, 1, 8,  "SET 1,A",    bind(&CPU::SET_r8,    this, 1, RegisterA) },
-		{ 0xD0, 1, 8,  "SET 2,B",    bind(&CPU::SET_r8,    this, 2, RegisterB) },
-		{ 0xD1, 1, 8,  "SET 2,C",    bind(&CPU::SET_r8,    this, 2, RegisterC) },
-		{ 0xD2, 1, 8,  "SET 2,D",    bind(&CPU::SET_r8,    this, 2, RegisterD) },
-		{ 0xD3, 1, 8,  "SET 2,E",    bind(&CPU::SET_r8,    this, 2, RegisterE) },
-		{ 0xD4, 1, 8,  "SET 2,H",    bind(&CPU::SET_r8,    this, 2, RegisterH) },
-		{ 0xD5, 1, 8,  "SET 2,L",    bind(&CPU::SET_r8,    this, 2, RegisterL) },
-		{ 0xD6, 1, 16, "SET 2,(HL)", bind(&CPU::SET_rp16,  this, 2, RegisterHL) },
-		{ 0xD7, 1, 8,  "SET 2,A",    bind(&CPU::SET_r8,    this, 2, RegisterA) },
-		{ 0xD8, 1, 8,  "SET 3,B",    bind(&CPU::SET_r8,    this, 3, RegisterB) },
-		{ 0xD9, 1, 8,  "SET 3,C",    bind(&CPU::SET_r8,    this, 3, RegisterC) },
-		{ 0xDA, 1, 8,  "SET 3,D",    bind(&CPU::SET_r8,    this, 3, RegisterD) },
-		{ 0xDB, 1, 8,  "SET 3,E",    bind(&CPU::SET_r8,    this, 3, RegisterE) },
-		{ 0xDC, 1, 8,  "SET 3,H",    bind(&CPU::SET_r8,    this, 3, RegisterH) },
-		{ 0xDD, 1, 8,  "SET 3,L",    bind(&CPU::SET_r8,    this, 3, RegisterL) },
-		{ 0xDE, 1, 16, "SET 3,(HL)", bind(&CPU::SET_rp16,  this, 3, RegisterHL) },
-		{ 0xDF, 1, 8,  "SET 3,A",    bind(&CPU::SET_r8,    this, 3, RegisterA) },
-		{ 0xE0, 1, 8,  "SET 4,B",    bind(&CPU::SET_r8,    this, 4, RegisterB) },
-		{ 0xE1, 1, 8,  "SET 4,C",    bind(&CPU::SET_r8,    this, 4, RegisterC) },
-		{ 0xE2, 1, 8,  "SET 4,D",    bind(&CPU::SET_r8,    this, 4, RegisterD) },
-		{ 0xE3, 1, 8,  "SET 4,E",    bind(&CPU::SET_r8,    this, 4, RegisterE) },
-		{ 0xE4, 1, 8,  "SET 4,H",    bind(&CPU::SET_r8,    this, 4, RegisterH) },
-		{ 0xE5, 1, 8,  "SET 4,L",    bind(&CPU::SET_r8,    this, 4, RegisterL) },
-		{ 0xE6, 1, 16, "SET 4,(HL)", bind(&CPU::SET_rp16,  this, 4, RegisterHL) },
-		{ 0xE7, 1, 8,  "SET 4,A",    bind(&CPU::SET_r8,    this, 4, RegisterA) },
-		{ 0xE8, 1, 8,  "SET 5,B",    bind(&CPU::SET_r8,    this, 5, RegisterB) },
-		{ 0xE9, 1, 8,  "SET 5,C",    bind(&CPU::SET_r8,    this, 5, RegisterC) },
-		{ 0xEA, 1, 8,  "SET 5,D",    bind(&CPU::SET_r8,    this, 5, RegisterD) },
-		{ 0xEB, 1, 8,  "SET 5,E",    bind(&CPU::SET_r8,    this, 5, RegisterE) },
-		{ 0xEC, 1, 8,  "SET 5,H",    bind(&CPU::SET_r8,    this, 5, RegisterH) },
-		{ 0xED, 1, 8,  "SET 5,L",    bind(&CPU::SET_r8,    this, 5, RegisterL) },
-		{ 0xEE, 1, 16, "SET 5,(HL)", bind(&CPU::SET_rp16,  this, 5, RegisterHL) },
-		{ 0xEF, 1, 8,  "SET 5,A",    bind(&CPU::SET_r8,    this, 5, RegisterA) },
-		{ 0xF0, 1, 8,  "SET 6,B",    bind(&CPU::SET_r8,    this, 6, RegisterB) },
-		{ 0xF1, 1, 8,  "SET 6,C",    bind(&CPU::SET_r8,    this, 6, RegisterC) },
-		{ 0xF2, 1, 8,  "SET 6,D",    bind(&CPU::SET_r8,    this, 6, RegisterD) },
-		{ 0xF3, 1, 8,  "SET 6,E",    bind(&CPU::SET_r8,    this, 6, RegisterE) },
-		{ 0xF4, 1, 8,  "SET 6,H",    bind(&CPU::SET_r8,    this, 6, RegisterH) },
-		{ 0xF5, 1, 8,  "SET 6,L",    bind(&CPU::SET_r8,    this, 6, RegisterL) },
-		{ 0xF6, 1, 16, "SET 6,(HL)", bind(&CPU::SET_rp16,  this, 6, RegisterHL) },
-		{ 0xF7, 1, 8,  "SET 6,A",    bind(&CPU::SET_r8,    this, 6, RegisterA) },
-		{ 0xF8, 1, 8,  "SET 7,B",    bind(&CPU::SET_r8,    this, 7, RegisterB) },
-		{ 0xF9, 1, 8,  "SET 7,C",    bind(&CPU::SET_r8,    this, 7, RegisterC) },
-		{ 0xFA, 1, 8,  "SET 7,D",    bind(&CPU::SET_r8,    this, 7, RegisterD) },
-		{ 0xFB, 1, 8,  "SET 7,E",    bind(&CPU::SET_r8,    this, 7, RegisterE) },
-		{ 0xFC, 1, 8,  "SET 7,H",    bind(&CPU::SET_r8,    this, 7, RegisterH) },
-		{ 0xFD, 1, 8,  "SET 7,L",    bind(&CPU::SET_r8,    this, 7, RegisterL) },
-		{ 0xFE, 1, 16, "SET 7,(HL)", bind(&CPU::SET_rp16,  this, 7, RegisterHL) },
-		{ 0xFF, 1, 8,  "SET 7,A",    bind(&CPU::SET_r8,    this, 7, RegisterA) },
-	};
+	(((this->*s_handlers[Ops])(), m_operand >>= 8 * (s_instructions[Ops].length - 1)), ...);
+}
+
+template<u8... Ops>
+constexpr CPU::Superinstruction CPU::fuse()
+{
+	static_assert(sizeof...(Ops) <= 4);
+	return { sizeof...(Ops), { Ops... }, (0 + ... + s_instructions[Ops].cycles), &CPU::superinstruction<Ops...>, &CPU::superinstructionThunk<Ops...> };
+}
+
+constexpr std::array<CPU::Superinstruction, 14> CPU::s_superinstructions = {
+	fuse<0x0B, 0x78, 0xB1, 0x20>(), // DEC BC ; LD A,B ; OR C ; JR NZ,r8
+	fuse<0x2A, 0x12, 0x13>(),       // LD A,(HL+) ; LD (DE),A ; INC DE
+	fuse<0x1A, 0x22, 0x13>(),       // LD A,(DE) ; LD (HL+),A ; INC DE
+	fuse<0x22, 0x05, 0x20>(),       // LD (HL+),A ; DEC B ; JR NZ,r8
+	fuse<0x2A, 0x12>(),             // LD A,(HL+) ; LD (DE),A
+	fuse<0x1A, 0x22>(),             // LD A,(DE) ; LD (HL+),A
+	fuse<0xF0, 0xFE>(),             // LDH A,(a8) ; CP d8
+	fuse<0xFE, 0x28>(),             // CP d8 ; JR Z,r8
+	fuse<0xFE, 0x20>(),             // CP d8 ; JR NZ,r8
+	fuse<0xFE, 0x38>(),             // CP d8 ; JR C,r8
+	fuse<0xFE, 0x30>(),             // CP d8 ; JR NC,r8
+	fuse<0xB7, 0x28>(),             // OR A ; JR Z,r8
+	fuse<0x05, 0x20>(),             // DEC B ; JR NZ,r8
+	fuse<0x0D, 0x20>(),             // DEC C ; JR NZ,r8
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<u8 Op>
+void CPU::breakpointTrap()
+{
+	u16 address = m_pc - s_instructions[Op].length;
+	if (m_breakpoints[address] && breakpointHit(address)) {
+		// The caller accounts for the instruction, which didn't run
+		m_cycles -= s_instructions[Op].cycles;
+		return;
+	}
+	(this->*s_handlers[Op])();
+}
+
+template<size_t... Ops>
+constexpr CPU::HandlerTable CPU::makeTrapTable(std::index_sequence<Ops...>)
+{
+	return { (s_handlers[Ops] != nullptr ? &CPU::breakpointTrap<Ops> : nullptr)... };
+}
 
-	for (auto i : cb_instructions)
-		m_cb_instruction_map.emplace(i.op, i);
+constexpr CPU::HandlerTable CPU::s_breakpoint_traps = makeTrapTable(std::make_index_sequence<256>());
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if BOI_HAS_JIT
+
+template<u8 Op, bool Prefixed>
+void CPU::opcodeThunk(CPU& cpu)
+{
+	constexpr Handler handler = Prefixed ? s_cb_handlers[Op] : s_handlers[Op];
+	if constexpr (handler != nullptr)
+		(cpu.*handler)();
 }
 
+template<bool Prefixed, size_t... Ops>
+constexpr CPU::ThunkTable CPU::makeThunkTable(std::index_sequence<Ops...>)
+{
+	return { &CPU::opcodeThunk<Ops, Prefixed>... };
+}
+
+constexpr CPU::ThunkTable CPU::s_thunks = makeThunkTable<false>(std::make_index_sequence<256>());
+constexpr CPU::ThunkTable CPU::s_cb_thunks = makeThunkTable<true>(std::make_index_sequence<256>());
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if BOI_HAS_THREADED_INTERPRETER
+
+#define FOR_EACH_OPCODE(X) \
+	X(00) X(01) X(02) X(03) X(04) X(05) X(06) X(07) X(08) X(09) X(0A) X(0B) X(0C) X(0D) X(0E) X(0F) \
+	X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(1A) X(1B) X(1C) X(1D) X(1E) X(1F) \
+	X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(2A) X(2B) X(2C) X(2D) X(2E) X(2F) \
+	X(30) X(31) X(32) X(33) X(34) X(35) X(36) X(37) X(38) X(39) X(3A) X(3B) X(3C) X(3D) X(3E) X(3F) \
+	X(40) X(41) X(42) X(43) X(44) X(45) X(46) X(47) X(48) X(49) X(4A) X(4B) X(4C) X(4D) X(4E) X(4F) \
+	X(50) X(51) X(52) X(53) X(54) X(55) X(56) X(57) X(58) X(59) X(5A) X(5B) X(5C) X(5D) X(5E) X(5F) \
+	X(60) X(61) X(62) X(63) X(64) X(65) X(66) X(67) X(68) X(69) X(6A) X(6B) X(6C) X(6D) X(6E) X(6F) \
+	X(70) X(71) X(72) X(73) X(74) X(75) X(76) X(77) X(78) X(79) X(7A) X(7B) X(7C) X(7D) X(7E) X(7F) \
+	X(80) X(81) X(82) X(83) X(84) X(85) X(86) X(87) X(88) X(89) X(8A) X(8B) X(8C) X(8D) X(8E) X(8F) \
+	X(90) X(91) X(92) X(93) X(94) X(95) X(96) X(97) X(98) X(99) X(9A) X(9B) X(9C) X(9D) X(9E) X(9F) \
+	X(A0) X(A1) X(A2) X(A3) X(A4) X(A5) X(A6) X(A7) X(A8) X(A9) X(AA) X(AB) X(AC) X(AD) X(AE) X(AF) \
+	X(B0) X(B1) X(B2) X(B3) X(B4) X(B5) X(B6) X(B7) X(B8) X(B9) X(BA) X(BB) X(BC) X(BD) X(BE) X(BF) \
+	X(C0) X(C1) X(C2) X(C3) X(C4) X(C5) X(C6) X(C7) X(C8) X(C9) X(CA) X(CB) X(CC) X(CD) X(CE) X(CF) \
+	X(D0) X(D1) X(D2) X(D3) X(D4) X(D5) X(D6) X(D7) X(D8) X(D9) X(DA) X(DB) X(DC) X(DD) X(DE) X(DF) \
+	X(E0) X(E1) X(E2) X(E3) X(E4) X(E5) X(E6) X(E7) X(E8) X(E9) X(EA) X(EB) X(EC) X(ED) X(EE) X(EF) \
+	X(F0) X(F1) X(F2) X(F3) X(F4) X(F5) X(F6) X(F7) X(F8) X(F9) X(FA) X(FB) X(FC) X(FD) X(FE) X(FF)
+
+template<u8 Op>
+inline void CPU::execOpcode()
+{
+	constexpr Handler handler = s_handlers[Op];
+	if constexpr (handler == nullptr)
+		ASSERT_MSG(false, "Unknown instruction " BG_WHITE "%02X" RESET, Op);
+	else {
+		fetchOperand(s_instructions[Op].length);
+		(this->*handler)();
+	}
+	m_cycles += s_instructions[Op].cycles;
+}
+
+template<u8 Op>
+inline void CPU::execCBOpcode()
+{
+	(this->*s_cb_handlers[Op])();
+	m_cycles += s_cb_instructions[Op].cycles;
+}
+
+void CPU::execThreaded(u64 deadline)
+{
+	// Every opcode gets its own copy of the dispatch sequence, so the host
+	// branch predictor sees one indirect jump per opcode instead of a single
+	// shared one. The handler calls are resolved at compile time.
+#define OPCODE_LABEL(op) &&op_##op,
+#define CB_OPCODE_LABEL(op) &&cb_op_##op,
+	static void* const labels[256] = { FOR_EACH_OPCODE(OPCODE_LABEL) };
+	static void* const cb_labels[256] = { FOR_EACH_OPCODE(CB_OPCODE_LABEL) };
+#undef OPCODE_LABEL
+#undef CB_OPCODE_LABEL
+
+	setDeadline(deadline);
+
+	// Handlers are bound at compile time here, breakpoints need the table.
+	// Profiling only sees the table interpreter.
+	if (m_has_breakpoints || m_profile) {
+		while (!reachedDeadline())
+			execNextInstruction();
+		return;
+	}
+
+	u8 op_code;
+
+#define DISPATCH() \
+	if (reachedDeadline()) \
+		return; \
+	if (m_trace) \
+		traceInstruction(); \
+	op_code = m_mmu.silent_read8(m_pc++); \
+	goto *labels[op_code];
+
+#define OPCODE_BODY(op) \
+	op_##op: \
+	if (0x##op == 0xCB) { \
+		op_code = m_mmu.silent_read8(m_pc++); \
+		goto *cb_labels[op_code]; \
+	} \
+	if (m_superinstruction_heads[0x##op] && execSuperinstruction(m_pc - 1, 0x##op)) { \
+		DISPATCH(); \
+	} \
+	execOpcode<0x##op>(); \
+	DISPATCH();
+
+#define CB_OPCODE_BODY(op) \
+	cb_op_##op: \
+	execCBOpcode<0x##op>(); \
+	DISPATCH();
+
+	DISPATCH();
+	FOR_EACH_OPCODE(OPCODE_BODY)
+	FOR_EACH_OPCODE(CB_OPCODE_BODY)
+
+#undef DISPATCH
+#undef OPCODE_BODY
+#undef CB_OPCODE_BODY
+}
+
+#undef FOR_EACH_OPCODE
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 }
\ No newline at end of file
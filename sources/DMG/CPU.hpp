@@ -7,22 +7,53 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "BlockCache.hpp"
+#include "JIT.hpp"
 #include "MMU.hpp"
+#include "OpcodeProfile.hpp"
+#include "TraceBuffer.hpp"
 #include "Utils/Assertions.hpp"
 #include "Utils/Types.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
 #include <functional>
-#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// The threaded interpreter relies on the labels-as-values GNU extension.
+#if defined(__GNUC__)
+	#define BOI_HAS_THREADED_INTERPRETER 1
+#else
+	#define BOI_HAS_THREADED_INTERPRETER 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
 namespace DMG
 {
 
-class CPU
+// Bit positions in the IE and IF registers, by decreasing priority
+enum class Interrupt : u8
 {
+	VBlank = 0,
+	LCDStat,
+	Timer,
+	Serial,
+	Joypad,
+};
+
+class CPU final : public IODevice
+{
+#if BOI_HAS_JIT
+	friend class JIT;
+#endif
+
 	union Register
 	{
 		struct {
@@ -63,22 +94,117 @@ class CPU
 		Carry     = 0x10,
 	};
 
+	// Operation that last defined the flags. Flags are only computed from
+	// its operands and result when something reads them.
+	enum class FlagOp : u8
+	{
+		None, // F holds every flag
+		Sub,  // CP
+		Inc,
+		Dec,
+		Logic,
+		Bit,
+	};
+
+	struct LazyFlags
+	{
+		FlagOp op = FlagOp::None;
+		u8 lhs = 0;
+		u8 rhs = 0;
+		u8 result = 0;
+	};
+
+	using Handler = void (CPU::*)();
+
 	struct Instruction
+	{
+		u8 length;
+		u8 cycles;
+		const char* mnemonic;
+	};
+
+	struct InstructionDefinition
 	{
 		u8 op;
 		u8 length;
 		u8 cycles;
 		const char* mnemonic;
-		std::function<void()> handler;
+		Handler handler;
+	};
+
+	using HandlerTable = std::array<Handler, 256>;
+	using InstructionTable = std::array<Instruction, 256>;
+
+	using Thunk = void (*)(CPU&);
+	using ThunkTable = std::array<Thunk, 256>;
+
+	// Sequence of opcodes run as a single handler
+	struct Superinstruction
+	{
+		u8 length;
+		u8 ops[4];
+		u8 cycles;
+		Handler handler;
+		Thunk thunk;
 	};
 
 public:
 	explicit CPU(MMU&);
 	void dump() const;
-	void execNextInstruction() { execNextInstructionWithMap(m_instruction_map); }
+	void execNextInstruction();
+	// Both run until the cycle counter reaches the deadline
+	void execBlocks(u64 deadline);
+#if BOI_HAS_JIT
+	void enableJIT();
+#endif
+#if BOI_HAS_THREADED_INTERPRETER
+	void execThreaded(u64 deadline);
+#endif
 
-	u8 imm8();
-	u16 imm16();
+	// Instructions only get interrupted between two runs. Anything changing
+	// IME, IE or IF ends the current run early so that they get serviced.
+	void setDeadline(u64 deadline) { m_deadline = m_ime_pending ? std::min(deadline, m_ime_enable_at) : deadline; }
+	bool reachedDeadline() const { return m_cycles >= m_deadline; }
+	void requestExit() { m_deadline = m_cycles; }
+	// Events scheduled by the running code may be due before the deadline
+	void shortenDeadline(u64 deadline) { m_deadline = std::min(m_deadline, deadline); }
+
+	// Breakpoints on the inclusive [begin, end] range. Arming them patches a
+	// per-CPU copy of the dispatch table with trapping handlers and makes
+	// every breakpoint a block of its own, so nothing gets checked while
+	// none is armed. The threaded interpreter falls back to the table
+	// meanwhile. A hit stops before the instruction, which runs on resume.
+	void addBreakpoint(u16 begin, u16 end);
+	void clearBreakpoints();
+	void setBreakpointHandler(std::function<void(u16 address)> handler) { m_breakpoint_handler = std::move(handler); }
+
+	// Records the opcode sequences run by the table interpreter, with
+	// superinstructions disabled
+	void enableProfiling();
+	const OpcodeProfile* profile() const { return m_profile.get(); }
+	// Profiles the next INSTRUCTIONS instructions on the table interpreter,
+	// then enables the superinstructions that made up enough of them
+	void profileSuperinstructions(u64 instructions);
+	// Opcodes are keyed 0000-00FF, prefixed ones CB00-CBFF
+	static const char* mnemonic(u16 opcode);
+
+	// Records every instruction. Superinstructions, idle loop skipping and
+	// the recompiler are left out while tracing, so that none is missed.
+	void setTraceBuffer(TraceBuffer*);
+
+	void requestInterrupt(Interrupt);
+	void serviceInterrupts();
+
+	// HALT and STOP end the current run. Nothing can wake the CPU before the
+	// next event, so time skips straight to it.
+	bool halted() const { return m_halted; }
+	void idleUntil(u64 deadline) { m_cycles = std::max(m_cycles, deadline); }
+
+	u8 readIO(u16 address) override;
+	void writeIO(u16 address, u8 value) override;
+
+	u8 imm8() const { return m_operand & 0xFF; }
+	u16 imm16() const { return m_operand; }
 	void push8(u8);
 	void push16(u16);
 	u8 pop8();
@@ -90,6 +216,7 @@ public:
 	void decImpl(u8& value);
 	void incImpl(u8& value);
 	void jpImpl(u16 location, bool condition = true, u8 cycles_on_success = 0);
+	void orImpl(u8 value);
 	void resImpl(u8 bit, u8& value);
 	void retImpl(bool condition = true, u8 cycles_on_success = 0);
 	void setImpl(u8 bit, u8& value);
@@ -106,199 +233,328 @@ private:
 	 * up = dereference immediate value (pointer)
 	 */
 
-	void ADC_r8_r8(RegisterIndex8, RegisterIndex8) { TODO(); }
-	void ADC_r8_rp16(RegisterIndex8, RegisterIndex16) { TODO(); }
-	void ADC_r8_u8(RegisterIndex8) { TODO(); }
-	void ADD_r16_i8(RegisterIndex16) { TODO(); }
-	void ADD_r16_r16(RegisterIndex16, RegisterIndex16) { TODO(); }
-	void ADD_r8_r8(RegisterIndex8, RegisterIndex8) { TODO(); }
-	void ADD_r8_rp16(RegisterIndex8, RegisterIndex16) { TODO(); }
-	void ADD_r8_u8(RegisterIndex8) { TODO(); }
-	void AND_r8(RegisterIndex8) { TODO(); }
-	void AND_rp16(RegisterIndex16) { TODO(); }
+	template<RegisterIndex8 R1, RegisterIndex8 R2> void ADC_r8_r8() { TODO(); }
+	template<RegisterIndex8 R, RegisterIndex16 P> void ADC_r8_rp16() { TODO(); }
+	template<RegisterIndex8 R> void ADC_r8_u8() { TODO(); }
+	template<RegisterIndex16 R> void ADD_r16_i8() { TODO(); }
+	template<RegisterIndex16 R1, RegisterIndex16 R2> void ADD_r16_r16() { TODO(); }
+	template<RegisterIndex8 R1, RegisterIndex8 R2> void ADD_r8_r8() { TODO(); }
+	template<RegisterIndex8 R, RegisterIndex16 P> void ADD_r8_rp16() { TODO(); }
+	template<RegisterIndex8 R> void ADD_r8_u8() { TODO(); }
+	template<RegisterIndex8 R> void AND_r8() { TODO(); }
+	template<RegisterIndex16 P> void AND_rp16() { TODO(); }
 	void AND_u8() { TODO(); }
-	void BIT_r8(u8, RegisterIndex8);
-	void BIT_rp16(u8, RegisterIndex16);
-	void CALL_C_u16(Flags);
-	void CALL_NC_u16(Flags);
+	template<u8 Bit, RegisterIndex8 R> void BIT_r8();
+	template<u8 Bit, RegisterIndex16 P> void BIT_rp16();
+	template<Flags F> void CALL_C_u16();
+	template<Flags F> void CALL_NC_u16();
 	void CALL_u16();
 	void CCF() { TODO(); }
-	void CP_r8(RegisterIndex8);
-	void CP_rp16(RegisterIndex16);
+	template<RegisterIndex8 R> void CP_r8();
+	template<RegisterIndex16 P> void CP_rp16();
 	void CP_u8();
 	void CPL() { TODO(); }
 	void DAA() { TODO(); }
-	void DEC_r16(RegisterIndex16);
-	void DEC_r8(RegisterIndex8);
-	void DEC_rp16(RegisterIndex16);
-	void DI() { printf(BG_BRED "TODO\n" RESET); }
-	void EI() { printf(BG_BRED "TODO\n" RESET); }
-	void HALT() { TODO(); }
-	void INC_r16(RegisterIndex16);
-	void INC_r8(RegisterIndex8);
-	void INC_rp16(RegisterIndex16);
-	void JP_C_u16(Flags);
-	void JP_NC_u16(Flags);
-	void JP_r16(RegisterIndex16);
+	template<RegisterIndex16 R> void DEC_r16();
+	template<RegisterIndex8 R> void DEC_r8();
+	template<RegisterIndex16 P> void DEC_rp16();
+	void DI();
+	void EI();
+	void HALT();
+	template<RegisterIndex16 R> void INC_r16();
+	template<RegisterIndex8 R> void INC_r8();
+	template<RegisterIndex16 P> void INC_rp16();
+	template<Flags F> void JP_C_u16();
+	template<Flags F> void JP_NC_u16();
+	template<RegisterIndex16 R> void JP_r16();
 	void JP_u16();
-	void JR_C_i8(Flags);
+	template<Flags F> void JR_C_i8();
 	void JR_i8();
-	void JR_NC_i8(Flags);
-	void LD_r16_r16(RegisterIndex16, RegisterIndex16);
-	void LD_r16_r16i8(RegisterIndex16, RegisterIndex16);
-	void LD_r16_u16(RegisterIndex16);
-	void LD_r8_r8(RegisterIndex8, RegisterIndex8);
-	void LD_r8_rp16(RegisterIndex8, RegisterIndex16);
-	void LD_r8_u8(RegisterIndex8);
-	void LD_r8_up16(RegisterIndex8);
-	void LD_rp16_r8(RegisterIndex16, RegisterIndex8);
-	void LD_rp16_u8(RegisterIndex16);
-	void LD_up16_r16(RegisterIndex16);
-	void LD_up16_r8(RegisterIndex8);
-	void LDD_r8_rp16(RegisterIndex8, RegisterIndex16) { TODO(); }
-	void LDD_rp16_r8(RegisterIndex16, RegisterIndex8);
-	void LDH_r8_rp8(RegisterIndex8, RegisterIndex8) { TODO(); }
-	void LDH_r8_up8(RegisterIndex8);
-	void LDH_rp8_r8(RegisterIndex8, RegisterIndex8) { TODO(); }
-	void LDH_up8_r8(RegisterIndex8);
-	void LDI_r8_rp16(RegisterIndex8, RegisterIndex16) { TODO(); }
-	void LDI_rp16_r8(RegisterIndex16, RegisterIndex8);
+	template<Flags F> void JR_NC_i8();
+	template<RegisterIndex16 R1, RegisterIndex16 R2> void LD_r16_r16();
+	template<RegisterIndex16 R1, RegisterIndex16 R2> void LD_r16_r16i8();
+	template<RegisterIndex16 R> void LD_r16_u16();
+	template<RegisterIndex8 R1, RegisterIndex8 R2> void LD_r8_r8();
+	template<RegisterIndex8 R, RegisterIndex16 P> void LD_r8_rp16();
+	template<RegisterIndex8 R> void LD_r8_u8();
+	template<RegisterIndex8 R> void LD_r8_up16();
+	template<RegisterIndex16 P, RegisterIndex8 R> void LD_rp16_r8();
+	template<RegisterIndex16 P> void LD_rp16_u8();
+	template<RegisterIndex16 R> void LD_up16_r16();
+	template<RegisterIndex8 R> void LD_up16_r8();
+	template<RegisterIndex8 R, RegisterIndex16 P> void LDD_r8_rp16() { TODO(); }
+	template<RegisterIndex16 P, RegisterIndex8 R> void LDD_rp16_r8();
+	template<RegisterIndex8 R, RegisterIndex8 P> void LDH_r8_rp8() { TODO(); }
+	template<RegisterIndex8 R> void LDH_r8_up8();
+	template<RegisterIndex8 P, RegisterIndex8 R> void LDH_rp8_r8() { TODO(); }
+	template<RegisterIndex8 R> void LDH_up8_r8();
+	template<RegisterIndex8 R, RegisterIndex16 P> void LDI_r8_rp16();
+	template<RegisterIndex16 P, RegisterIndex8 R> void LDI_rp16_r8();
 	void NOP() {}
-	void OR_r8(RegisterIndex8) { TODO(); }
-	void OR_rp16(RegisterIndex16) { TODO(); }
-	void OR_u8() { TODO(); }
-	void POP_r16(RegisterIndex16);
-	void PUSH_r16(RegisterIndex16);
-	void RES_r8(u8, RegisterIndex8);
-	void RES_rp16(u8, RegisterIndex16);
+	template<RegisterIndex8 R> void OR_r8();
+	template<RegisterIndex16 P> void OR_rp16();
+	void OR_u8();
+	void PREFIX_CB();
+	template<RegisterIndex16 R> void POP_r16();
+	template<RegisterIndex16 R> void PUSH_r16();
+	template<u8 Bit, RegisterIndex8 R> void RES_r8();
+	template<u8 Bit, RegisterIndex16 P> void RES_rp16();
 	void RET();
-	void RET_C(Flags);
-	void RET_NC(Flags);
-	void RETI() { TODO(); }
-	void RL_r8(RegisterIndex8) { TODO(); }
-	void RL_rp16(RegisterIndex16) { TODO(); }
-	void RLC_r8(RegisterIndex8) { TODO(); }
-	void RLC_rp16(RegisterIndex16) { TODO(); }
-	void RR_r8(RegisterIndex8) { TODO(); }
-	void RR_rp16(RegisterIndex16) { TODO(); }
-	void RRC_r8(RegisterIndex8) { TODO(); }
-	void RRC_rp16(RegisterIndex16) { TODO(); }
-	void RST(u8);
-	void SBC_r8_r8(RegisterIndex8, RegisterIndex8) { TODO(); }
-	void SBC_r8_rp16(RegisterIndex8, RegisterIndex16) { TODO(); }
-	void SBC_r8_u8(RegisterIndex8) { TODO(); }
+	template<Flags F> void RET_C();
+	template<Flags F> void RET_NC();
+	void RETI();
+	template<RegisterIndex8 R> void RL_r8() { TODO(); }
+	template<RegisterIndex16 P> void RL_rp16() { TODO(); }
+	template<RegisterIndex8 R> void RLC_r8() { TODO(); }
+	template<RegisterIndex16 P> void RLC_rp16() { TODO(); }
+	template<RegisterIndex8 R> void RR_r8() { TODO(); }
+	template<RegisterIndex16 P> void RR_rp16() { TODO(); }
+	template<RegisterIndex8 R> void RRC_r8() { TODO(); }
+	template<RegisterIndex16 P> void RRC_rp16() { TODO(); }
+	template<u8 Location> void RST();
+	template<RegisterIndex8 R1, RegisterIndex8 R2> void SBC_r8_r8() { TODO(); }
+	template<RegisterIndex8 R, RegisterIndex16 P> void SBC_r8_rp16() { TODO(); }
+	template<RegisterIndex8 R> void SBC_r8_u8() { TODO(); }
 	void SCF() { TODO(); }
-	void SET_r8(u8, RegisterIndex8);
-	void SET_rp16(u8, RegisterIndex16);
-	void SLA_r8(RegisterIndex8) { TODO(); }
-	void SLA_rp16(RegisterIndex16) { TODO(); }
-	void SRA_r8(RegisterIndex8) { TODO(); }
-	void SRA_rp16(RegisterIndex16) { TODO(); }
-	void SRL_r8(RegisterIndex8) { TODO(); }
-	void SRL_rp16(RegisterIndex16) { TODO(); }
-	void STOP() { TODO(); }
-	void SUB_r8(RegisterIndex8) { TODO(); }
-	void SUB_rp16(RegisterIndex16) { TODO(); }
+	template<u8 Bit, RegisterIndex8 R> void SET_r8();
+	template<u8 Bit, RegisterIndex16 P> void SET_rp16();
+	template<RegisterIndex8 R> void SLA_r8() { TODO(); }
+	template<RegisterIndex16 P> void SLA_rp16() { TODO(); }
+	template<RegisterIndex8 R> void SRA_r8() { TODO(); }
+	template<RegisterIndex16 P> void SRA_rp16() { TODO(); }
+	template<RegisterIndex8 R> void SRL_r8() { TODO(); }
+	template<RegisterIndex16 P> void SRL_rp16() { TODO(); }
+	void STOP();
+	template<RegisterIndex8 R> void SUB_r8() { TODO(); }
+	template<RegisterIndex16 P> void SUB_rp16() { TODO(); }
 	void SUB_u8() { TODO(); }
-	void SWAP_r8(RegisterIndex8);
-	void SWAP_rp16(RegisterIndex16);
-	void XOR_r8(RegisterIndex8);
-	void XOR_rp16(RegisterIndex16);
+	template<RegisterIndex8 R> void SWAP_r8();
+	template<RegisterIndex16 P> void SWAP_rp16();
+	template<RegisterIndex8 R> void XOR_r8();
+	template<RegisterIndex16 P> void XOR_rp16();
 	void XOR_u8();
 
-	void execNextInstructionWithMap(std::map<u8, Instruction>&);
-	void fillInstructionsMap();
-	void fillCBInstructionsMap();
+	void execNextInstructionWithTables(const HandlerTable&, const InstructionTable&);
+	void execBlock(const BlockCache::Block&);
+	// Returns false for instructions that can't start a block
+	bool decodeBlock(BlockCache::Block&);
+	void fetchOperand(u8 length);
+	static bool endsBlock(u8 op_code);
+	static bool isIdleLoop(const BlockCache::Block&);
+	void fuseSuperinstructions(std::vector<BlockCache::Op>&) const;
+	void selectSuperinstructions(const OpcodeProfile&);
+	// Runs the enabled superinstruction starting with the HEAD opcode at PC,
+	// if any
+	bool execSuperinstruction(u16 pc, u8 head);
+
+	// Immediates of the fused instructions are packed in m_operand, first
+	// one in the low byte
+	template<u8... Ops> void superinstruction();
+	template<u8... Ops> static void superinstructionThunk(CPU& cpu) { cpu.superinstruction<Ops...>(); }
+	template<u8... Ops> static constexpr Superinstruction fuse();
+#if BOI_HAS_JIT
+	template<u8 Op, bool Prefixed> static void opcodeThunk(CPU&);
+	template<bool Prefixed, size_t... Ops> static constexpr ThunkTable makeThunkTable(std::index_sequence<Ops...>);
+#endif
+#if BOI_HAS_THREADED_INTERPRETER
+	template<u8 Op> void execOpcode();
+	template<u8 Op> void execCBOpcode();
+#endif
+
+	template<u8 Op> void breakpointTrap();
+	template<size_t... Ops> static constexpr HandlerTable makeTrapTable(std::index_sequence<Ops...>);
+	// Sole operation of the blocks decoded at a breakpoint
+	void breakpointOp();
+	// Returns whether execution stops, or resumes from this breakpoint
+	bool breakpointHit(u16 address);
+
+	template<size_t N> static constexpr HandlerTable makeHandlerTable(const InstructionDefinition (&)[N]);
+	template<size_t N> static constexpr InstructionTable makeInstructionTable(const InstructionDefinition (&)[N]);
 
 public:
-	u8 reg8(RegisterIndex8 r) const
+	// Registers are stored in pairs, the first register of each pair (A, B,
+	// D, H) being the most significant byte.
+	template<RegisterIndex8 R>
+	u8 reg8() const
 	{
-		switch (r) {
-			case RegisterA: return m_registers[RegisterAF].lower_byte;
-			case RegisterF: return m_registers[RegisterAF].higher_byte;
-			case RegisterB: return m_registers[RegisterBC].lower_byte;
-			case RegisterC: return m_registers[RegisterBC].higher_byte;
-			case RegisterD: return m_registers[RegisterDE].lower_byte;
-			case RegisterE: return m_registers[RegisterDE].higher_byte;
-			case RegisterH: return m_registers[RegisterHL].lower_byte;
-			case RegisterL: return m_registers[RegisterHL].higher_byte;
-		}
-		ASSERT_NOT_REACHED();
+		if constexpr (R % 2 == 0)
+			return m_registers[R / 2].higher_byte;
+		else
+			return m_registers[R / 2].lower_byte;
 	}
 
-	u8& reg8(RegisterIndex8 r)
+	template<RegisterIndex8 R>
+	u8& reg8()
 	{
-		switch (r) {
-			case RegisterA: return m_registers[RegisterAF].lower_byte;
-			case RegisterF: return m_registers[RegisterAF].higher_byte;
-			case RegisterB: return m_registers[RegisterBC].lower_byte;
-			case RegisterC: return m_registers[RegisterBC].higher_byte;
-			case RegisterD: return m_registers[RegisterDE].lower_byte;
-			case RegisterE: return m_registers[RegisterDE].higher_byte;
-			case RegisterH: return m_registers[RegisterHL].lower_byte;
-			case RegisterL: return m_registers[RegisterHL].higher_byte;
-		}
-		ASSERT_NOT_REACHED();
+		if constexpr (R % 2 == 0)
+			return m_registers[R / 2].higher_byte;
+		else
+			return m_registers[R / 2].lower_byte;
 	}
 
 	u16 reg16(RegisterIndex16 r) const { return m_registers[r].word; }
 	u16& reg16(RegisterIndex16 r) { return m_registers[r].word; }
 
-	u16 af() const { return reg16(RegisterAF); }
+	u16 af() const { return (a() << 8) | f(); }
 	u16 bc() const { return reg16(RegisterBC); }
 	u16 de() const { return reg16(RegisterDE); }
 	u16 hl() const { return reg16(RegisterHL); }
 	u16 sp() const { return reg16(RegisterSP); }
 	u16 pc() const { return m_pc; }
+	u64 cycles() const { return m_cycles; }
+	const u64& clock() const { return m_cycles; }
+	bool ime() const { return m_ime; }
 
-	u8 a() const { return reg8(RegisterA); }
-	u8 f() const { return reg8(RegisterF); }
-	u8 b() const { return reg8(RegisterB); }
-	u8 c() const { return reg8(RegisterC); }
-	u8 d() const { return reg8(RegisterD); }
-	u8 e() const { return reg8(RegisterE); }
-	u8 h() const { return reg8(RegisterH); }
-	u8 l() const { return reg8(RegisterL); }
+	u8 a() const { return reg8<RegisterA>(); }
+	u8 f() const { return m_flags.op == FlagOp::None ? reg8<RegisterF>() : computeFlags(); }
+	u8 b() const { return reg8<RegisterB>(); }
+	u8 c() const { return reg8<RegisterC>(); }
+	u8 d() const { return reg8<RegisterD>(); }
+	u8 e() const { return reg8<RegisterE>(); }
+	u8 h() const { return reg8<RegisterH>(); }
+	u8 l() const { return reg8<RegisterL>(); }
 
-	void setAF(u16 value) { reg16(RegisterAF) = value; }
+	void setAF(u16 value) { setA(value >> 8); setF(value & 0xFF); }
 	void setBC(u16 value) { reg16(RegisterBC) = value; }
 	void setDE(u16 value) { reg16(RegisterDE) = value; }
 	void setHL(u16 value) { reg16(RegisterHL) = value; }
 	void setSP(u16 value) { reg16(RegisterSP) = value; }
 
-	void setA(u8 value) { reg8(RegisterA) = value; }
-	void setF(u8 value) { reg8(RegisterF) = value; }
-	void setB(u8 value) { reg8(RegisterB) = value; }
-	void setC(u8 value) { reg8(RegisterC) = value; }
-	void setD(u8 value) { reg8(RegisterD) = value; }
-	void setE(u8 value) { reg8(RegisterE) = value; }
-	void setH(u8 value) { reg8(RegisterH) = value; }
-	void setL(u8 value) { reg8(RegisterL) = value; }
+	void setA(u8 value) { reg8<RegisterA>() = value; }
+	void setF(u8 value) { reg8<RegisterF>() = value & 0xF0; m_flags.op = FlagOp::None; }
+	void setB(u8 value) { reg8<RegisterB>() = value; }
+	void setC(u8 value) { reg8<RegisterC>() = value; }
+	void setD(u8 value) { reg8<RegisterD>() = value; }
+	void setE(u8 value) { reg8<RegisterE>() = value; }
+	void setH(u8 value) { reg8<RegisterH>() = value; }
+	void setL(u8 value) { reg8<RegisterL>() = value; }
 
-	bool zf() const { return f() & Zero; }
+	bool zf() const { return m_flags.op == FlagOp::None ? reg8<RegisterF>() & Zero : m_flags.result == 0; }
 	bool nf() const { return f() & Substract; }
 	bool hf() const { return f() & HalfCarry; }
-	bool cf() const { return f() & Carry; }
+	bool cf() const
+	{
+		switch (m_flags.op) {
+			case FlagOp::Sub: return m_flags.lhs < m_flags.rhs;
+			case FlagOp::Logic: return false;
+			default: return reg8<RegisterF>() & Carry;
+		}
+	}
 
-	void resetFlags() { reg8(RegisterF) = 0; }
+	template<Flags F>
+	bool flag() const
+	{
+		if constexpr (F == Zero)
+			return zf();
+		else if constexpr (F == Carry)
+			return cf();
+		else
+			return f() & F;
+	}
+
+	void resetFlags() { setF(0); }
 
 	void setFlags(Flags flags, bool value)
 	{
-		if (value)
-			reg8(RegisterF) |= flags;
-		else
-			reg8(RegisterF) &= ~flags;
+		u8 current = f();
+		setF(value ? current | flags : current & ~flags);
 	}
 
 private:
+	u8 computeFlags() const;
+
+	void traceInstruction()
+	{
+		TraceRecord record {};
+		record.kind = TraceRecord::Instruction;
+		record.cycles = m_cycles;
+		record.pc = m_pc;
+		record.sp = sp();
+		record.a = a(); record.f = f();
+		record.b = b(); record.c = c();
+		record.d = d(); record.e = e();
+		record.h = h(); record.l = l();
+		for (u8 i = 0; i < 4; ++i)
+			record.pcmem[i] = m_mmu.silent_read8(m_pc + i);
+		m_trace->push(record);
+	}
+
+	// Records a lazily evaluated operation, keeping the carry flag as it was
+	void setLazyFlagsKeepingCarry(FlagOp op, u8 result)
+	{
+		reg8<RegisterF>() = cf() ? Carry : 0;
+		m_flags = { op, 0, 0, result };
+	}
+
 	MMU& m_mmu;
-	u32 m_cycles = 0;
+	u64 m_cycles = 0;
+	u64 m_deadline = 0;
+
+	// Interrupt master enable. EI only sets it once the next instruction ran.
+	bool m_ime = false;
+	bool m_ime_pending = false;
+	u64 m_ime_enable_at = 0;
+	u8 m_ie = 0x00;
+	u8 m_if = 0x01;
+
+	bool m_halted = false;
+	bool m_stopped = false; // Only woken up by the joypad
 
 	Register m_registers[5];
 	u16 m_pc = 0x0100;
 
-	std::map<u8, Instruction> m_instruction_map;
-	std::map<u8, Instruction> m_cb_instruction_map;
+	// When m_flags.op is not None, F only holds the flags it left untouched
+	LazyFlags m_flags;
+
+	// Immediate operand of the instruction being executed
+	u16 m_operand = 0;
+
+	BlockCache m_block_cache;
+	std::unique_ptr<OpcodeProfile> m_profile;
+	u64 m_profile_remaining = 0;
+
+	// Enabled entries of s_superinstructions, in the same order, and the
+	// opcodes any of them starts with
+	std::vector<const Superinstruction*> m_superinstructions;
+	std::array<bool, 256> m_superinstruction_heads {};
+
+	TraceBuffer* m_trace = nullptr;
+#if BOI_HAS_JIT
+	std::unique_ptr<JIT> m_jit;
+#endif
+
+	// s_handlers, or s_breakpoint_traps while breakpoints are armed
+	HandlerTable m_handlers;
+	std::bitset<0x10000> m_breakpoints;
+	bool m_has_breakpoints = false;
+	int m_resume_breakpoint = -1;
+	std::function<void(u16 address)> m_breakpoint_handler;
+
+	static const InstructionDefinition s_definitions[];
+	static const InstructionDefinition s_cb_definitions[];
+
+	// Hot dispatch tables, indexed by opcode. Unassigned opcodes are null.
+	static const HandlerTable s_handlers;
+	static const HandlerTable s_cb_handlers;
+
+	// Cold per-opcode metadata, only touched for cycle accounting and tracing.
+	static const InstructionTable s_instructions;
+	static const InstructionTable s_cb_instructions;
+
+	// Check for a breakpoint before running the instruction
+	static const HandlerTable s_breakpoint_traps;
+
+	// Candidates for fusion, longest first as the first match is used. Those
+	// making up at least 1/s_superinstruction_share of the instructions of
+	// the profiling pass get enabled.
+	static const std::array<Superinstruction, 14> s_superinstructions;
+	static constexpr u64 s_superinstruction_share = 256;
+
+#if BOI_HAS_JIT
+	// Plain function entry points for every handler, called by native code
+	static const ThunkTable s_thunks;
+	static const ThunkTable s_cb_thunks;
+#endif
 };
 
 }
\ No newline at end of file
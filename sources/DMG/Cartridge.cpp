@@ -0,0 +1,371 @@
+/*
+** Boi, 2020
+** DMG / Cartridge.cpp
+*/
+
+#include "Cartridge.hpp"
+#include "Utils/Assertions.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Reads past the end of the ROM
+static const std::array<u8, 0x100> s_open_bus = [] {
+	std::array<u8, 0x100> page;
+	page.fill(0xFF);
+	return page;
+}();
+
+std::unique_ptr<Cartridge> Cartridge::create(std::shared_ptr<const MappedFile> rom)
+{
+	const u8* header = static_cast<const u8*>(rom->data());
+	if (rom->size() < 0x150)
+		return std::make_unique<NoMBC>(std::move(rom), 0);
+
+	static constexpr size_t ram_sizes[] = { 0, 0x800, 0x2000, 0x8000, 0x20000, 0x10000 };
+	u8 ram_code = header[0x149];
+	size_t ram_size = ram_code < std::size(ram_sizes) ? ram_sizes[ram_code] : 0;
+
+	std::unique_ptr<Cartridge> cartridge;
+	u8 type = header[0x147];
+	switch (type) {
+		case 0x00: case 0x08: case 0x09:
+			cartridge = std::make_unique<NoMBC>(std::move(rom), ram_size);
+			break;
+		case 0x01: case 0x02: case 0x03:
+			cartridge = std::make_unique<MBC1>(std::move(rom), ram_size);
+			break;
+		case 0x05: case 0x06:
+			cartridge = std::make_unique<MBC2>(std::move(rom));
+			break;
+		case 0x0F: case 0x10:
+			cartridge = std::make_unique<MBC3>(std::move(rom), ram_size, true);
+			break;
+		case 0x11: case 0x12: case 0x13:
+			cartridge = std::make_unique<MBC3>(std::move(rom), ram_size, false);
+			break;
+		case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E:
+			cartridge = std::make_unique<MBC5>(std::move(rom), ram_size);
+			break;
+		default:
+			ASSERT_MSG(false, "Unsupported cartridge type " BG_WHITE "%02X" RESET, type);
+	}
+
+	switch (type) {
+		case 0x03: case 0x06: case 0x09: case 0x0F: case 0x10: case 0x13: case 0x1B: case 0x1E:
+			cartridge->m_battery = true;
+			break;
+	}
+	return cartridge;
+}
+
+Cartridge::Cartridge(std::shared_ptr<const MappedFile> rom, size_t ram_size, size_t extra_size)
+: m_rom(std::move(rom))
+, m_rom_banks(std::max<size_t>(2, (m_rom->size() + 0x3FFF) / 0x4000))
+, m_ram_size(ram_size)
+, m_storage_size(ram_size + extra_size)
+, m_memory(m_storage_size, 0x00)
+{
+	m_ram = m_memory.data();
+}
+
+Cartridge::~Cartridge()
+{
+	if (!m_flusher.joinable())
+		return;
+
+	{
+		std::lock_guard lock(m_flush_mutex);
+		m_stopping = true;
+	}
+	m_flush_condition.notify_one();
+	m_flusher.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Cartridge::attachSave(const std::string& filename)
+{
+	ASSERT(!m_save);
+	if (m_storage_size == 0)
+		return false;
+
+	std::error_code error;
+	size_t saved_size = std::filesystem::file_size(filename, error);
+	if (error)
+		saved_size = 0;
+
+	auto save = std::make_unique<MappedFile>(filename, m_storage_size);
+	if (!save->isMapped())
+		return false;
+
+	u8* storage = static_cast<u8*>(save->data());
+	if (saved_size < m_storage_size)
+		memcpy(storage + saved_size, m_ram + saved_size, m_storage_size - saved_size);
+
+	m_save = std::move(save);
+	m_ram = storage;
+	m_flusher = std::thread(&Cartridge::flushLoop, this);
+	return true;
+}
+
+void Cartridge::setRAMEnabled(bool enabled)
+{
+	bool disabling = m_ram_enabled && !enabled;
+	m_ram_enabled = enabled;
+	if (!disabling || !m_save || !m_dirty.load(std::memory_order_relaxed))
+		return;
+
+	// Games disable RAM once done saving, flush right away
+	{
+		std::lock_guard lock(m_flush_mutex);
+		m_flush_requested = true;
+	}
+	m_flush_condition.notify_one();
+}
+
+void Cartridge::flushLoop()
+{
+	std::unique_lock lock(m_flush_mutex);
+	while (!m_stopping) {
+		m_flush_condition.wait_for(lock, s_flush_interval, [this] { return m_flush_requested || m_stopping; });
+		m_flush_requested = false;
+
+		// Writes landing during the flush set the flag again
+		if (!m_dirty.exchange(false))
+			continue;
+		lock.unlock();
+		m_save->sync();
+		lock.lock();
+	}
+
+	if (m_dirty.exchange(false))
+		m_save->sync();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const u8* Cartridge::romPage(u8 page) const
+{
+	u16 bank = romBank(page << 8);
+	size_t offset = bank * 0x4000 + (page & 0x3F) * 0x100;
+	if (offset + 0x100 > romSize())
+		return s_open_bus.data();
+	return rom() + offset;
+}
+
+const u8* Cartridge::ramPage(u8 page) const
+{
+	if (!ramMapped() || m_ram_size == 0)
+		return nullptr;
+	return m_ram + (m_ram_bank * 0x2000 + (page - 0xA0) * 0x100) % m_ram_size;
+}
+
+u8* Cartridge::ramWritePage(u8 page)
+{
+	if (m_battery)
+		return nullptr;
+	return const_cast<u8*>(ramPage(page));
+}
+
+u8 Cartridge::readRAM(u16) const
+{
+	return 0xFF;
+}
+
+void Cartridge::writeRAM(u16 address, u8 value)
+{
+	if (!ramMapped() || m_ram_size == 0)
+		return;
+	m_ram[(m_ram_bank * 0x2000 + (address - 0xA000)) % m_ram_size] = value;
+	markDirty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+NoMBC::NoMBC(std::shared_ptr<const MappedFile> rom, size_t ram_size)
+: Cartridge(std::move(rom), ram_size)
+{
+	m_ram_enabled = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MBC1::writeRegister(u16 address, u8 value)
+{
+	if (address < 0x2000)
+		setRAMEnabled((value & 0x0F) == 0x0A);
+	else if (address < 0x4000)
+		m_bank_low = (value & 0x1F) ? value & 0x1F : 1;
+	else if (address < 0x6000)
+		m_bank_high = value & 0x03;
+	else
+		m_advanced_banking = value & 0x01;
+
+	m_rom_bank0 = m_advanced_banking ? m_bank_high << 5 : 0;
+	m_rom_bank1 = (m_bank_high << 5) | m_bank_low;
+	m_ram_bank = m_advanced_banking ? m_bank_high : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MBC2::MBC2(std::shared_ptr<const MappedFile> rom)
+: Cartridge(std::move(rom), 0x200)
+{
+}
+
+void MBC2::writeRegister(u16 address, u8 value)
+{
+	if (address >= 0x4000)
+		return;
+
+	// Address bit 8 selects the register
+	if (address & 0x0100)
+		m_rom_bank1 = (value & 0x0F) ? value & 0x0F : 1;
+	else
+		setRAMEnabled((value & 0x0F) == 0x0A);
+}
+
+u8 MBC2::readRAM(u16 address) const
+{
+	if (!m_ram_enabled)
+		return 0xFF;
+	return m_ram[address & 0x1FF] | 0xF0;
+}
+
+void MBC2::writeRAM(u16 address, u8 value)
+{
+	if (!m_ram_enabled)
+		return;
+	m_ram[address & 0x1FF] = value & 0x0F;
+	markDirty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MBC3::MBC3(std::shared_ptr<const MappedFile> rom, size_t ram_size, bool has_clock)
+: Cartridge(std::move(rom), ram_size, has_clock ? sizeof(ClockState) : 0)
+, m_has_clock(has_clock)
+{
+	if (m_has_clock)
+		clock() = ClockState { std::time(nullptr), -1, 0, {} };
+}
+
+void MBC3::writeRegister(u16 address, u8 value)
+{
+	if (address < 0x2000)
+		setRAMEnabled((value & 0x0F) == 0x0A);
+	else if (address < 0x4000)
+		m_rom_bank1 = (value & 0x7F) ? value & 0x7F : 1;
+	else if (address < 0x6000)
+		m_ram_bank = value & 0x0F;
+	else {
+		// Writing 00 then 01 latches the clock
+		if (m_latch_state == 0x00 && value == 0x01)
+			latchClock();
+		m_latch_state = value;
+	}
+}
+
+u8 MBC3::readRAM(u16) const
+{
+	if (!m_ram_enabled || !m_has_clock || m_ram_bank < 0x08 || m_ram_bank > 0x0C)
+		return 0xFF;
+	return m_latched[m_ram_bank - 0x08];
+}
+
+void MBC3::writeRAM(u16 address, u8 value)
+{
+	if (ramMapped())
+		return Cartridge::writeRAM(address, value);
+	if (!m_ram_enabled || !m_has_clock || m_ram_bank < 0x08 || m_ram_bank > 0x0C)
+		return;
+
+	i64 seconds = clockSeconds();
+	i64 s = seconds % 60;
+	i64 m = seconds / 60 % 60;
+	i64 h = seconds / 3600 % 24;
+	i64 days = seconds / 86400;
+
+	switch (m_ram_bank - 0x08) {
+		case Seconds: s = value % 60; break;
+		case Minutes: m = value % 60; break;
+		case Hours: h = value % 24; break;
+		case DaysLow: days = (days & 0x100) | value; break;
+		case DaysHigh: {
+			days = (days & 0xFF) | ((value & 0x01) << 8);
+			clock().day_carry = value >> 7;
+			bool halt = value & 0x40;
+			if (halt && clock().halted_seconds < 0)
+				clock().halted_seconds = seconds;
+			else if (!halt && clock().halted_seconds >= 0)
+				clock().halted_seconds = -1;
+			break;
+		}
+	}
+
+	setClockSeconds(((days * 24 + h) * 60 + m) * 60 + s);
+	m_latched[m_ram_bank - 0x08] = value;
+}
+
+i64 MBC3::clockSeconds() const
+{
+	if (clock().halted_seconds >= 0)
+		return clock().halted_seconds;
+	return std::time(nullptr) - clock().origin;
+}
+
+void MBC3::setClockSeconds(i64 seconds)
+{
+	if (clock().halted_seconds >= 0)
+		clock().halted_seconds = seconds;
+	else
+		clock().origin = std::time(nullptr) - seconds;
+	markDirty();
+}
+
+void MBC3::latchClock()
+{
+	// The day counter has 9 bits, overflowing sets the carry until cleared
+	static constexpr i64 s_day_counter_period = 512 * 86400;
+
+	i64 seconds = clockSeconds();
+	if (seconds >= s_day_counter_period) {
+		clock().day_carry = 1;
+		seconds %= s_day_counter_period;
+		setClockSeconds(seconds);
+	}
+
+	i64 days = seconds / 86400;
+	m_latched[Seconds] = seconds % 60;
+	m_latched[Minutes] = seconds / 60 % 60;
+	m_latched[Hours] = seconds / 3600 % 24;
+	m_latched[DaysLow] = days & 0xFF;
+	m_latched[DaysHigh] = (days >> 8) | (clock().halted_seconds >= 0 ? 0x40 : 0) | (clock().day_carry ? 0x80 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MBC5::writeRegister(u16 address, u8 value)
+{
+	if (address < 0x2000)
+		setRAMEnabled((value & 0x0F) == 0x0A);
+	else if (address < 0x3000)
+		m_rom_bank1 = (m_rom_bank1 & 0x100) | value;
+	else if (address < 0x4000)
+		m_rom_bank1 = (m_rom_bank1 & 0x0FF) | ((value & 0x01) << 8);
+	else if (address < 0x6000)
+		m_ram_bank = value & 0x0F;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,188 @@
+/*
+** Boi, 2020
+** DMG / Cartridge.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/MappedFile.hpp"
+#include "Utils/Types.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// ROM and external RAM behind the bank controller. The ROM is used in place
+// from the mapped file, which instances running the same game share.
+//
+// Battery-backed RAM can live in a shared mapping of a save file. Writes to
+// it set a dirty flag, and a background thread flushes the mapping to disk
+// periodically or when the game disables RAM. The kernel keeps the mapping's
+// contents if the process gets killed, the flushes cover host crashes.
+class Cartridge
+{
+public:
+	static std::unique_ptr<Cartridge> create(std::shared_ptr<const MappedFile> rom);
+
+	virtual ~Cartridge();
+
+	// Pages 00-7F
+	const u8* romPage(u8 page) const;
+	// Pages A0-BF, null when reads must go through readRAM
+	const u8* ramPage(u8 page) const;
+	// Null when writes must go through writeRAM, which battery-backed RAM
+	// always does to set the dirty flag
+	u8* ramWritePage(u8 page);
+	// Bank mapped at a ROM address
+	u16 romBank(u16 address) const { return (address < 0x4000 ? m_rom_bank0 : m_rom_bank1) % m_rom_banks; }
+
+	// Handles writes to 0000-7FFF
+	virtual void writeRegister(u16 address, u8 value) = 0;
+
+	// RAM area accesses without a page
+	virtual u8 readRAM(u16 address) const;
+	virtual void writeRAM(u16 address, u8 value);
+
+	const u8* rom() const { return static_cast<const u8*>(m_rom->data()); }
+	size_t romSize() const { return m_rom->size(); }
+	u16 romBanks() const { return m_rom_banks; }
+	size_t ramSize() const { return m_ram_size; }
+
+	bool hasBattery() const { return m_battery; }
+	// Moves RAM to the save file, loading its contents. Parts of the file
+	// missing or too short get the current contents. Returns false when the
+	// file could not be mapped, RAM then stays in memory.
+	bool attachSave(const std::string& filename);
+
+protected:
+	// Controllers needing more persistent state than RAM reserve
+	// extra_size bytes after it
+	Cartridge(std::shared_ptr<const MappedFile> rom, size_t ram_size, size_t extra_size = 0);
+
+	// Whether the RAM area maps m_ram as plain banked memory
+	virtual bool ramMapped() const { return m_ram_enabled; }
+
+	void setRAMEnabled(bool enabled);
+	void markDirty() { m_dirty.store(true, std::memory_order_relaxed); }
+
+	std::shared_ptr<const MappedFile> m_rom;
+	u16 m_rom_banks;
+	bool m_battery = false;
+
+	// RAM then the controller's extra state, in m_memory or m_save
+	u8* m_ram;
+	size_t m_ram_size;
+	size_t m_storage_size;
+
+	u16 m_rom_bank0 = 0;
+	u16 m_rom_bank1 = 1;
+	u8 m_ram_bank = 0;
+	bool m_ram_enabled = false;
+
+private:
+	static constexpr auto s_flush_interval = std::chrono::seconds(1);
+
+	void flushLoop();
+
+	std::vector<u8> m_memory;
+	std::unique_ptr<MappedFile> m_save;
+
+	std::atomic<bool> m_dirty = false;
+	std::thread m_flusher;
+	std::mutex m_flush_mutex;
+	std::condition_variable m_flush_condition;
+	bool m_flush_requested = false;
+	bool m_stopping = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+class NoMBC final : public Cartridge
+{
+public:
+	NoMBC(std::shared_ptr<const MappedFile> rom, size_t ram_size);
+	void writeRegister(u16, u8) override {}
+};
+
+class MBC1 final : public Cartridge
+{
+public:
+	MBC1(std::shared_ptr<const MappedFile> rom, size_t ram_size) : Cartridge(std::move(rom), ram_size) {}
+	void writeRegister(u16 address, u8 value) override;
+
+private:
+	u8 m_bank_low = 1;
+	u8 m_bank_high = 0;
+	bool m_advanced_banking = false;
+};
+
+// 512 half-bytes of RAM built into the controller
+class MBC2 final : public Cartridge
+{
+public:
+	explicit MBC2(std::shared_ptr<const MappedFile> rom);
+	void writeRegister(u16 address, u8 value) override;
+	u8 readRAM(u16 address) const override;
+	void writeRAM(u16 address, u8 value) override;
+
+protected:
+	bool ramMapped() const override { return false; }
+};
+
+class MBC3 final : public Cartridge
+{
+public:
+	MBC3(std::shared_ptr<const MappedFile> rom, size_t ram_size, bool has_clock);
+	void writeRegister(u16 address, u8 value) override;
+	u8 readRAM(u16 address) const override;
+	void writeRAM(u16 address, u8 value) override;
+
+protected:
+	// Clock registers are selected with banks 08-0C
+	bool ramMapped() const override { return m_ram_enabled && m_ram_bank < 0x08; }
+
+private:
+	enum ClockRegister { Seconds, Minutes, Hours, DaysLow, DaysHigh, ClockRegisterCount };
+
+	// Saved after RAM. The clock follows the host time, counting from
+	// origin, so it keeps running while the emulator is closed.
+	struct ClockState
+	{
+		i64 origin;
+		i64 halted_seconds; // Clock value while halted, or -1
+		u8 day_carry;
+		u8 reserved[7];
+	};
+
+	ClockState& clock() { return *reinterpret_cast<ClockState*>(m_ram + m_ram_size); }
+	const ClockState& clock() const { return *reinterpret_cast<const ClockState*>(m_ram + m_ram_size); }
+	i64 clockSeconds() const;
+	void setClockSeconds(i64 seconds);
+	void latchClock();
+
+	bool m_has_clock;
+	u8 m_latched[ClockRegisterCount] {};
+	u8 m_latch_state = 0xFF;
+};
+
+class MBC5 final : public Cartridge
+{
+public:
+	MBC5(std::shared_ptr<const MappedFile> rom, size_t ram_size) : Cartridge(std::move(rom), ram_size) {}
+	void writeRegister(u16 address, u8 value) override;
+};
+
+}
@@ -4,6 +4,10 @@
 */
 
 #include "Core.hpp"
+#include "Utils/Assertions.hpp"
+#include "Utils/Trace.hpp"
+
+#include <algorithm>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -12,10 +16,43 @@ namespace DMG
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Core::Core(MappedFile&& rom_file)
-: m_mmu((const u8*)rom_file.data(), rom_file.size())
+Core::Core(std::shared_ptr<const MappedFile> rom_file, Interpreter interpreter, PPU::Engine ppu_engine)
+: m_mmu(std::move(rom_file))
 , m_cpu(m_mmu)
-{}
+, m_scheduler(m_cpu.clock())
+, m_timer(m_scheduler, m_cpu, m_mmu)
+, m_ppu(m_scheduler, m_cpu, m_mmu, ppu_engine)
+, m_serial(m_scheduler, m_cpu, m_mmu)
+, m_dma(m_scheduler, m_mmu)
+, m_interpreter(interpreter)
+{
+#if !BOI_HAS_THREADED_INTERPRETER
+	ASSERT_MSG(m_interpreter != Interpreter::Threaded, "Threaded interpreter not available in this build");
+#endif
+
+#if BOI_HAS_JIT
+	if (m_interpreter == Interpreter::Recompiler)
+		m_cpu.enableJIT();
+#else
+	ASSERT_MSG(m_interpreter != Interpreter::Recompiler, "Recompiler not available in this build");
+#endif
+
+	m_cpu.profileSuperinstructions(s_profiled_instructions);
+
+	m_scheduler.setScheduledHandler([this](u64 timestamp) { m_cpu.shortenDeadline(timestamp); });
+
+	m_cpu.setBreakpointHandler([this](u16 address) {
+		printf(RED "BREAK " CYAN "[%04X]" RESET "\n", address);
+		stop();
+	});
+	m_mmu.setWatchHandler([this](const MMU::Watchpoint&, MMU::WatchAccess access, u16 address, u8 value) {
+		if (access == MMU::WatchRead)
+			printf(GREEN "WATCH READ " CYAN "[%04X]" RESET " -> " MAGENTA "%02X" RESET " (%s)\n", address, value, MMU::findRegion(address).name);
+		else
+			printf(YELLOW "WATCH WRITE " CYAN "[%04X]" RESET " <- " MAGENTA "%02X" RESET " (%s)\n", address, value, MMU::findRegion(address).name);
+		stop();
+	});
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -23,17 +60,71 @@ void Core::run()
 {
 	m_running = true;
 
-	while (m_running) {
-		m_cpu.execNextInstruction();
-		dump();
+	while (m_running)
+		runFor(s_cycles_per_frame);
+}
+
+void Core::runFor(u64 cycles)
+{
+	const u64 end = m_cpu.cycles() + cycles;
+	m_stopped = false;
+
+	while (m_cpu.cycles() < end && !m_stopped) {
+		m_cpu.serviceInterrupts();
+
+		u64 deadline = std::min(m_scheduler.nextDeadline(), end);
+		if (m_cpu.halted())
+			m_cpu.idleUntil(deadline);
+		else
+			runCPU(deadline);
+
+		m_scheduler.dispatch();
+	}
+}
+
+void Core::runCPU(u64 deadline)
+{
+	switch (m_interpreter) {
+		case Interpreter::Table:
+			m_cpu.setDeadline(deadline);
+			while (!m_cpu.reachedDeadline()) {
+				m_cpu.execNextInstruction();
+				if constexpr (Trace::enabled<Trace::Registers>)
+					dump();
+			}
+			break;
+		case Interpreter::Threaded:
+#if BOI_HAS_THREADED_INTERPRETER
+			m_cpu.execThreaded(deadline);
+#endif
+			break;
+		case Interpreter::Blocks:
+		case Interpreter::Recompiler:
+			m_cpu.execBlocks(deadline);
+			break;
 	}
 }
 
+void Core::enableTraceBuffer(size_t capacity_log2)
+{
+	m_trace_buffer = std::make_unique<TraceBuffer>(capacity_log2);
+	m_cpu.setTraceBuffer(m_trace_buffer.get());
+	m_mmu.setTraceBuffer(m_trace_buffer.get());
+}
+
 void Core::dump() const
 {
 	m_cpu.dump();
 }
 
+void Core::stop()
+{
+	dump();
+	m_cpu.requestExit();
+	m_stopped = true;
+	m_running = false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 }
\ No newline at end of file
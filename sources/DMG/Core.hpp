@@ -8,9 +8,17 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "CPU.hpp"
+#include "DMA.hpp"
 #include "MMU.hpp"
+#include "PPU.hpp"
+#include "Scheduler.hpp"
+#include "Serial.hpp"
+#include "Timer.hpp"
+#include "TraceBuffer.hpp"
 #include "Utils/MappedFile.hpp"
 
+#include <memory>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DMG
@@ -19,19 +27,66 @@ namespace DMG
 class Core
 {
 public:
-	explicit Core(MappedFile&& rom_file);
+	enum class Interpreter
+	{
+		Table,
+		Threaded,
+		Blocks,
+		Recompiler,
+	};
+
+public:
+	static constexpr u32 s_cycles_per_frame = 70224;
+	// The first instructions of a ROM are profiled to pick the
+	// superinstructions worth enabling for it
+	static constexpr u64 s_profiled_instructions = 1 << 20;
+
+public:
+	// Instances may share the same ROM file
+	explicit Core(std::shared_ptr<const MappedFile> rom_file, Interpreter = Interpreter::Table, PPU::Engine = PPU::Engine::Scanline);
 
 	void run();
+	// Emulates at least the given number of cycles, serving every event due
+	void runFor(u64 cycles);
+	// Breakpoint and watchpoint hits print the CPU state and stop run() or
+	// runFor(). Block interpreters finish the current block after a
+	// watchpoint hit. Running again resumes.
+	bool stopped() const { return m_stopped; }
 	void dump() const;
 
 	CPU& cpu() { return m_cpu; }
 	MMU& mmu() { return m_mmu; }
+	PPU& ppu() { return m_ppu; }
+
+	void addBreakpoint(u16 begin, u16 end) { m_cpu.addBreakpoint(begin, end); }
+	void addWatchpoint(u16 begin, u16 end, u8 access) { m_mmu.addWatchpoint(begin, end, access); }
+
+	// Keeps battery-backed cartridge RAM in a save file
+	bool attachSave(const std::string& filename) { return m_mmu.attachSave(filename); }
+
+	// Starts recording the latest 2^capacity_log2 instructions and memory accesses
+	void enableTraceBuffer(size_t capacity_log2);
+	const TraceBuffer* traceBuffer() const { return m_trace_buffer.get(); }
+	Scheduler& scheduler() { return m_scheduler; }
 
 private:
+	// Runs the CPU until the next event is due
+	void runCPU(u64 deadline);
+	void stop();
+
 	MMU m_mmu;
 	CPU m_cpu;
+	Scheduler m_scheduler;
+	Timer m_timer;
+	PPU m_ppu;
+	Serial m_serial;
+	DMA m_dma;
+
+	std::unique_ptr<TraceBuffer> m_trace_buffer;
 
+	Interpreter m_interpreter;
 	bool m_running = false;
+	bool m_stopped = false;
 };
 
 }
\ No newline at end of file
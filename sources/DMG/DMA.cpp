@@ -0,0 +1,53 @@
+/*
+** Boi, 2020
+** DMG / DMA.cpp
+*/
+
+#include "DMA.hpp"
+#include "Utils/Assertions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+DMA::DMA(Scheduler& scheduler, MMU& mmu)
+: m_scheduler(scheduler)
+, m_mmu(mmu)
+{
+	m_mmu.mapIO(0xFF46, this);
+
+	m_scheduler.setHandler(Event::OAMDMA, [this](u64) { transferDone(); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+u8 DMA::readIO(u16 address)
+{
+	ASSERT(address == 0xFF46);
+	return m_source;
+}
+
+void DMA::writeIO(u16 address, u8 value)
+{
+	ASSERT(address == 0xFF46);
+
+	// Restarting a transfer copies again and extends the lock
+	m_source = value;
+	m_mmu.copyToOAM(m_source);
+	m_mmu.setDMALocked(true);
+	m_scheduler.schedule(Event::OAMDMA, m_scheduler.now() + s_transfer_cycles);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void DMA::transferDone()
+{
+	m_mmu.setDMALocked(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,41 @@
+/*
+** Boi, 2020
+** DMG / DMA.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MMU.hpp"
+#include "Scheduler.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// OAM DMA. The 160 bytes are copied at once when the transfer starts, the
+// bus then stays locked until its completion event.
+class DMA final : public IODevice
+{
+public:
+	DMA(Scheduler&, MMU&);
+
+	u8 readIO(u16 address) override;
+	void writeIO(u16 address, u8 value) override;
+
+private:
+	void transferDone();
+
+	Scheduler& m_scheduler;
+	MMU& m_mmu;
+
+	u8 m_source = 0xFF;
+
+	// One byte per machine cycle
+	static constexpr u64 s_transfer_cycles = 160 * 4;
+};
+
+}
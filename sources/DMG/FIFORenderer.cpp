@@ -0,0 +1,43 @@
+/*
+** Boi, 2020
+** DMG / FIFORenderer.cpp
+*/
+
+#include "FIFORenderer.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+FIFORenderer::FIFORenderer(VideoMemory& video)
+: m_pipeline(video)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FIFORenderer::beginLine(u8 ly, const LCDRegisters& registers, const LineSprites& sprites, u64 timestamp)
+{
+	m_ly = ly;
+	m_start = timestamp;
+	m_pipeline.beginLine(ly, registers, sprites);
+}
+
+void FIFORenderer::advance(const LCDRegisters& registers, u64 timestamp)
+{
+	m_pipeline.advance(registers, timestamp - m_start, m_framebuffer[m_ly]);
+}
+
+void FIFORenderer::endLine(const LCDRegisters& registers, u64 timestamp)
+{
+	// The PPU ends the transfer on the last pixel, the line is complete
+	advance(registers, timestamp);
+	m_pipeline.endLine();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
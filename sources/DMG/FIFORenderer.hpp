@@ -0,0 +1,39 @@
+/*
+** Boi, 2020
+** DMG / FIFORenderer.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelPipeline.hpp"
+#include "Renderer.hpp"
+#include "VideoMemory.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Draws lines dot by dot like the hardware, through the fetcher and pixel
+// FIFO of a PixelPipeline. The PPU times mode 3 with a pipeline of its own,
+// so the line ends right as its last pixel is drawn.
+class FIFORenderer final : public Renderer
+{
+public:
+	explicit FIFORenderer(VideoMemory&);
+
+	void beginLine(u8 ly, const LCDRegisters&, const LineSprites&, u64 timestamp) override;
+	void advance(const LCDRegisters&, u64 timestamp) override;
+	void endLine(const LCDRegisters&, u64 timestamp) override;
+
+private:
+	PixelPipeline m_pipeline;
+
+	u8 m_ly = 0;
+	u64 m_start = 0;
+};
+
+}
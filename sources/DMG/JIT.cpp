@@ -0,0 +1,255 @@
+/*
+** Boi, 2020
+** DMG / JIT.cpp
+*/
+
+#include "JIT.hpp"
+
+#if BOI_HAS_JIT
+
+#include "CPU.hpp"
+#include "Utils/Assertions.hpp"
+
+#include <cstring>
+#include <sys/mman.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static i32 offsetIn(const CPU& cpu, const T& field)
+{
+	return reinterpret_cast<const u8*>(&field) - reinterpret_cast<const u8*>(&cpu);
+}
+
+JIT::JIT(CPU& cpu, BlockCache& block_cache)
+: m_cpu(cpu)
+, m_block_cache(block_cache)
+, m_pc_offset(offsetIn(cpu, cpu.m_pc))
+, m_operand_offset(offsetIn(cpu, cpu.m_operand))
+, m_cycles_offset(offsetIn(cpu, cpu.m_cycles))
+, m_deadline_offset(offsetIn(cpu, cpu.m_deadline))
+, m_registers_offset(offsetIn(cpu, cpu.m_registers))
+{
+	static_assert(sizeof(cpu.m_cycles) == 8, "Cycle counter updates are emitted as 64-bit adds");
+	static_assert(sizeof(cpu.m_deadline) == 8, "Deadline checks are emitted as 64-bit compares");
+
+	void* buffer = ::mmap(nullptr, s_buffer_size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ASSERT_MSG(buffer != MAP_FAILED, "Unable to map JIT buffer");
+
+	m_buffer = static_cast<u8*>(buffer);
+	m_cursor = m_buffer;
+}
+
+JIT::~JIT()
+{
+	m_block_cache.dropNativeCode();
+	::munmap(m_buffer, s_buffer_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BlockCache::NativeCode JIT::compile(const BlockCache::Block& block)
+{
+	if (m_cursor + (block.ops.size() + 1) * s_max_op_size > m_buffer + s_buffer_size)
+		flush();
+
+	u8* entry = m_cursor;
+	std::vector<u8*> exit_jumps;
+	u32 pending_cycles = 0;
+	bool last_inlined = false;
+
+	emit({ 0x53 });             // push rbx
+	emit({ 0x48, 0x89, 0xFB }); // mov rbx, rdi
+
+	for (size_t i = 0; i < block.ops.size(); ++i) {
+		auto& op = block.ops[i];
+
+		last_inlined = emitInline(op);
+		if (last_inlined) {
+			pending_cycles += op.cycles;
+			continue;
+		}
+
+		// Handlers observe the cycle counter as it was before their own
+		// instruction, like in the interpreter
+		emitAddCycles(pending_cycles);
+		emitStore16(m_pc_offset, op.next_pc);
+		emitStore16(m_operand_offset, op.operand);
+		const auto& thunks = op.prefixed ? CPU::s_cb_thunks : CPU::s_thunks;
+		CPU::Thunk thunk = op.fused ? CPU::s_superinstructions[op.op_code].thunk : thunks[op.op_code];
+		emitCall(reinterpret_cast<const void*>(thunk));
+		pending_cycles = op.cycles;
+
+		if (i + 1 == block.ops.size())
+			continue;
+
+		emitAddCycles(pending_cycles);
+		pending_cycles = 0;
+
+		// Blocks in RAM may overwrite themselves, leave as soon as they do
+		if (block.begin >= 0x8000) {
+			emit({ 0x48, 0xB8 }); // mov rax, &block.valid
+			emit64(reinterpret_cast<u64>(&block.valid));
+			emit({ 0x80, 0x38, 0x00 }); // cmp byte [rax], 0
+			emit({ 0x0F, 0x84 });       // je exit
+			exit_jumps.push_back(m_cursor);
+			emit32(0);
+		}
+
+		// Interrupts enabled or requested, leave before the next instruction
+		emit({ 0x48, 0x8B, 0x83 }); // mov rax, qword [rbx + m_cycles]
+		emit32(m_cycles_offset);
+		emit({ 0x48, 0x3B, 0x83 }); // cmp rax, qword [rbx + m_deadline]
+		emit32(m_deadline_offset);
+		emit({ 0x0F, 0x83 });       // jae exit
+		exit_jumps.push_back(m_cursor);
+		emit32(0);
+	}
+
+	if (last_inlined)
+		emitStore16(m_pc_offset, block.ops.back().next_pc);
+	emitAddCycles(pending_cycles);
+
+	for (u8* jump : exit_jumps) {
+		i32 displacement = m_cursor - (jump + 4);
+		memcpy(jump, &displacement, sizeof(displacement));
+	}
+
+	emit({ 0x5B }); // pop rbx
+	emit({ 0xC3 }); // ret
+
+	return reinterpret_cast<BlockCache::NativeCode>(entry);
+}
+
+void JIT::flush()
+{
+	m_block_cache.dropNativeCode();
+	m_cursor = m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool JIT::emitInline(const BlockCache::Op& op)
+{
+	if (op.prefixed || op.fused)
+		return false;
+
+	u8 code = op.op_code;
+
+	// NOP
+	if (code == 0x00)
+		return true;
+
+	// LD r8,r8
+	if (code >= 0x40 && code < 0x80 && code != 0x76 && (code & 7) != 6 && ((code >> 3) & 7) != 6) {
+		emit({ 0x0F, 0xB6, 0x83 }); // movzx eax, byte [rbx + src]
+		emit32(reg8Offset(code & 7));
+		emit({ 0x88, 0x83 });       // mov byte [rbx + dst], al
+		emit32(reg8Offset((code >> 3) & 7));
+		return true;
+	}
+
+	// LD r8,d8
+	if (code < 0x40 && (code & 7) == 6 && ((code >> 3) & 7) != 6) {
+		emit({ 0xC6, 0x83 }); // mov byte [rbx + dst], imm8
+		emit32(reg8Offset((code >> 3) & 7));
+		emit({ static_cast<u8>(op.operand) });
+		return true;
+	}
+
+	// LD r16,d16
+	if (code < 0x40 && (code & 0xF) == 0x1) {
+		emitStore16(reg16Offset(code >> 4), op.operand);
+		return true;
+	}
+
+	// INC r16, DEC r16
+	if (code < 0x40 && ((code & 0xF) == 0x3 || (code & 0xF) == 0xB)) {
+		emit({ 0x66, 0xFF, static_cast<u8>((code & 0xF) == 0x3 ? 0x83 : 0x8B) }); // inc/dec word [rbx + r16]
+		emit32(reg16Offset(code >> 4));
+		return true;
+	}
+
+	return false;
+}
+
+void JIT::emitCall(const void* function)
+{
+	emit({ 0x48, 0x89, 0xDF }); // mov rdi, rbx
+	emit({ 0x48, 0xB8 });       // mov rax, function
+	emit64(reinterpret_cast<u64>(function));
+	emit({ 0xFF, 0xD0 });       // call rax
+}
+
+void JIT::emitAddCycles(u32 cycles)
+{
+	if (cycles == 0)
+		return;
+	emit({ 0x48, 0x81, 0x83 }); // add qword [rbx + m_cycles], imm32
+	emit32(m_cycles_offset);
+	emit32(cycles);
+}
+
+void JIT::emitStore16(i32 offset, u16 value)
+{
+	emit({ 0x66, 0xC7, 0x83 }); // mov word [rbx + offset], imm16
+	emit32(offset);
+	emit16(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void JIT::emit(std::initializer_list<u8> bytes)
+{
+	for (u8 byte : bytes)
+		*m_cursor++ = byte;
+}
+
+void JIT::emit16(u16 value)
+{
+	memcpy(m_cursor, &value, sizeof(value));
+	m_cursor += sizeof(value);
+}
+
+void JIT::emit32(u32 value)
+{
+	memcpy(m_cursor, &value, sizeof(value));
+	m_cursor += sizeof(value);
+}
+
+void JIT::emit64(u64 value)
+{
+	memcpy(m_cursor, &value, sizeof(value));
+	m_cursor += sizeof(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+i32 JIT::reg8Offset(u8 field) const
+{
+	// Opcode register encoding (B, C, D, E, H, L, (HL), A) to CPU::RegisterIndex8
+	static constexpr u8 indices[8] = { 2, 3, 4, 5, 6, 7, 0xFF, 0 };
+	u8 index = indices[field];
+	ASSERT(index != 0xFF);
+
+	// The first register of each pair lives in the high byte
+	return m_registers_offset + (index / 2) * sizeof(u16) + (index % 2 == 0 ? 1 : 0);
+}
+
+i32 JIT::reg16Offset(u8 index) const
+{
+	// Opcode pair encoding (BC, DE, HL, SP) to CPU::RegisterIndex16
+	return m_registers_offset + (index + 1) * sizeof(u16);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+
+#endif
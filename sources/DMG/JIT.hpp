@@ -0,0 +1,84 @@
+/*
+** Boi, 2020
+** DMG / JIT.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BlockCache.hpp"
+#include "Utils/Types.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The recompiler emits x86-64 code into an mmap'd executable buffer.
+#if defined(__x86_64__) && defined(__linux__)
+	#define BOI_HAS_JIT 1
+#else
+	#define BOI_HAS_JIT 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if BOI_HAS_JIT
+
+namespace DMG
+{
+
+class CPU;
+
+// Recompiles hot basic blocks to native code. Register-only instructions are
+// inlined, everything else calls the interpreter's handler for that opcode
+// directly, so memory accesses keep their MMU semantics. The CPU's PC and
+// cycle counter are exact whenever a handler runs and when the block exits.
+class JIT
+{
+public:
+	static constexpr u32 s_hot_threshold = 32;
+
+	JIT(CPU&, BlockCache&);
+	~JIT();
+
+	JIT(const JIT&) = delete;
+	JIT& operator=(const JIT&) = delete;
+
+	BlockCache::NativeCode compile(const BlockCache::Block&);
+	void flush();
+
+private:
+	static constexpr size_t s_buffer_size = 16 * 1024 * 1024;
+	static constexpr size_t s_max_op_size = 128;
+
+	bool emitInline(const BlockCache::Op&);
+	void emitCall(const void* function);
+	void emitAddCycles(u32 cycles);
+	void emitStore16(i32 offset, u16 value);
+
+	void emit(std::initializer_list<u8>);
+	void emit16(u16);
+	void emit32(u32);
+	void emit64(u64);
+
+	i32 reg8Offset(u8 field) const;
+	i32 reg16Offset(u8 index) const;
+
+	CPU& m_cpu;
+	BlockCache& m_block_cache;
+
+	u8* m_buffer = nullptr;
+	u8* m_cursor = nullptr;
+
+	i32 m_pc_offset;
+	i32 m_operand_offset;
+	i32 m_cycles_offset;
+	i32 m_deadline_offset;
+	i32 m_registers_offset;
+};
+
+}
+
+#endif
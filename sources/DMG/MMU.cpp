@@ -5,6 +5,7 @@
 
 #include "MMU.hpp"
 #include "Utils/Assertions.hpp"
+#include "Utils/Trace.hpp"
 
 #include <cstring>
 #include <algorithm>
@@ -39,48 +40,301 @@ const MMU::Region MMU::s_regions[] = {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-MMU::MMU(const u8* rom_data, size_t rom_size)
+MMU::MMU(std::shared_ptr<const MappedFile> rom)
+: m_cartridge(Cartridge::create(std::move(rom)))
 {
-	memcpy(m_map, rom_data, std::min(rom_size, 0x8000UL));
+	updatePages(0x00, 0xFF);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-u8 MMU::read8(u16 address) const
+u8 MMU::slowRead8(u16 address, bool fetch) const
 {
-	u8 value = m_map[address];
-	printf(GREEN "READ " CYAN "[%04X]" RESET " -> " MAGENTA "%02X" RESET " (%s)\n", address, value, findRegion(address).name);
+	u8 value = peek(address, fetch);
+	if (m_watched_pages[address >> 8] & WatchRead && !fetch)
+		checkWatchpoints(WatchRead, address, value);
+	if constexpr (Trace::enabled<Trace::Memory>)
+		printf(GREEN "READ " CYAN "[%04X]" RESET " -> " MAGENTA "%02X" RESET " (%s)\n", address, value, findRegion(address).name);
+	if (m_trace)
+		traceAccess(TraceRecord::Read, address, value);
 	return value;
 }
 
-u8 MMU::silent_read8(u16 address) const
+void MMU::slowWrite8(u16 address, u8 value)
 {
-	return m_map[address];
+	if constexpr (Trace::enabled<Trace::Memory>)
+		printf(YELLOW "WRITE " CYAN "[%04X]" RESET " <- " MAGENTA "%02X" RESET " (%s)\n", address, value, findRegion(address).name);
+	if (m_trace)
+		traceAccess(TraceRecord::Write, address, value);
+	if (m_watched_pages[address >> 8] & WatchWrite)
+		checkWatchpoints(WatchWrite, address, value);
+	poke(address, value);
 }
 
-u16 MMU::read16(u16 address) const
+u8 MMU::peek(u16 address, bool fetch) const
 {
-	u16 value = m_map[address] | (m_map[address + 1] << 8);
-	printf(GREEN "READ " CYAN "[%04X]" RESET " -> " MAGENTA "%04X" RESET " (%s)\n", address, value, findRegion(address).name);
-	return value;
+	if (address >= 0xFF00) {
+		if (IODevice* device = m_io[address - 0xFF00])
+			return device->readIO(address);
+		return m_high[address - 0xFF00];
+	}
+	if (m_dma_locked && !fetch)
+		return 0xFF;
+	if (address >= 0xFE00) {
+		if (m_oam_locked)
+			return 0xFF;
+		return address < 0xFEA0 ? m_video.oam()[address - 0xFE00] : 0x00;
+	}
+	if (m_vram_locked && address >= 0x8000 && address < 0xA000)
+		return 0xFF;
+	if (const u8* page = m_read_backing[address >> 8])
+		return page[address & 0xFF];
+	return m_cartridge->readRAM(address);
+}
+
+void MMU::poke(u16 address, u8 value)
+{
+	if (address >= 0xFF00) {
+		if (IODevice* device = m_io[address - 0xFF00])
+			device->writeIO(address, value);
+		else
+			m_high[address - 0xFF00] = value;
+	}
+	else if (m_dma_locked)
+		return;
+	else if (address >= 0xFE00) {
+		if (m_oam_locked || address >= 0xFEA0)
+			return;
+		m_video.oam()[address - 0xFE00] = value;
+		for (auto& dirty : m_dirty_sprites)
+			dirty.set((address - 0xFE00) / 4);
+	}
+	else if (address < 0x8000) {
+		writeCartridgeRegister(address, value);
+		return;
+	}
+	else if (m_vram_locked && address < 0xA000)
+		return;
+	else if (u8* page = m_write_backing[address >> 8])
+		page[address & 0xFF] = value;
+	else
+		m_cartridge->writeRAM(address, value);
+
+	markDirty(address);
+
+	if (m_code_pages[address >> 8])
+		m_code_observer->codeWritten(address);
+
+	// Echo RAM and WRAM are the same memory, code may run from either
+	int mirror = mirrorPage(address >> 8);
+	if (mirror >= 0 && m_code_pages[mirror])
+		m_code_observer->codeWritten((mirror << 8) | (address & 0xFF));
+}
+
+void MMU::writeCartridgeRegister(u16 address, u8 value)
+{
+	u16 bank0 = m_cartridge->romBank(0x0000);
+	u16 bank1 = m_cartridge->romBank(0x4000);
+	const u8* ram = m_cartridge->ramPage(0xA0);
+
+	m_cartridge->writeRegister(address, value);
+
+	if (m_cartridge->romBank(0x0000) != bank0)
+		updatePages(0x00, 0x3F);
+	if (m_cartridge->romBank(0x4000) != bank1)
+		updatePages(0x40, 0x7F);
+	if (m_cartridge->ramPage(0xA0) == ram)
+		return;
+
+	updatePages(0xA0, 0xBF);
+
+	// Code decoded from the previous RAM bank is gone
+	for (unsigned page = 0xA0; page <= 0xBF; ++page) {
+		for (unsigned offset = 0; m_code_pages[page] && offset < 0x100; ++offset)
+			m_code_observer->codeWritten((page << 8) | offset);
+	}
+}
+
+void MMU::markDirty(u16 address)
+{
+	if (address >= 0x8000 && address < 0xA000)
+		m_video.markDirty(address);
+
+	u8 page = canonicalPage(address >> 8);
+	if (m_dirty_pages[page])
+		return;
+
+	// Later writes to the page can go direct
+	m_dirty_pages.set(page);
+	updatePage(page);
+	if (int mirror = mirrorPage(page); mirror >= 0)
+		updatePage(mirror);
+}
+
+void MMU::clearDirtyPages(u8 first, u8 last)
+{
+	for (unsigned page = first; page <= last; ++page) {
+		if (!m_dirty_pages[canonicalPage(page)])
+			continue;
+		m_dirty_pages.reset(canonicalPage(page));
+		updatePage(page);
+		if (int mirror = mirrorPage(page); mirror >= 0)
+			updatePage(mirror);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const u8* MMU::readBacking(u8 page)
+{
+	if (page < 0x80)
+		return m_cartridge->romPage(page);
+	if (page >= 0xA0 && page < 0xC0)
+		return m_cartridge->ramPage(page);
+	return writeBacking(page);
+}
+
+u8* MMU::writeBacking(u8 page)
+{
+	u16 address = page << 8;
+
+	if (address < 0x8000)
+		return nullptr;
+	if (address < 0xA000)
+		return m_video.vram() + (address - 0x8000);
+	if (address < 0xC000)
+		return m_cartridge->ramWritePage(page);
+	if (address < 0xE000)
+		return m_wram + (address - 0xC000);
+	if (address < 0xFE00)
+		return m_wram + (address - 0xE000);
+	return nullptr;
+}
+
+void MMU::updatePage(u8 page)
+{
+	u16 address = page << 8;
+	int mirror = mirrorPage(page);
+	bool locked = (m_vram_locked && address >= 0x8000 && address < 0xA000) || (m_dma_locked && page != 0xFF);
+	bool has_code = m_code_pages[page] || (mirror >= 0 && m_code_pages[mirror]);
+	bool direct = !Trace::enabled<Trace::Memory> && m_trace == nullptr && !locked;
+	bool tracked = address < 0xA000 || !m_dirty_pages[canonicalPage(page)];
+	u8 watched = m_watched_pages[page];
+
+	m_read_backing[page] = readBacking(page);
+	m_write_backing[page] = writeBacking(page);
+	m_read_pages[page] = direct && !(watched & WatchRead) ? m_read_backing[page] : nullptr;
+	m_write_pages[page] = direct && !has_code && !tracked && !(watched & WatchWrite) ? m_write_backing[page] : nullptr;
+}
+
+void MMU::updatePages(u8 first, u8 last)
+{
+	for (unsigned page = first; page <= last; ++page)
+		updatePage(page);
+}
+
+void MMU::setCodePage(u8 page, bool has_code)
+{
+	m_code_pages[page] = has_code;
+	updatePage(page);
+
+	// Writes through the other mirror must be caught too
+	int mirror = mirrorPage(page);
+	if (mirror >= 0)
+		updatePage(mirror);
+}
+
+void MMU::setVRAMLocked(bool locked)
+{
+	if (m_vram_locked == locked)
+		return;
+	m_vram_locked = locked;
+	updatePages(0x80, 0x9F);
+}
+
+void MMU::setOAMLocked(bool locked)
+{
+	m_oam_locked = locked;
+}
+
+void MMU::setDMALocked(bool locked)
+{
+	if (m_dma_locked == locked)
+		return;
+	m_dma_locked = locked;
+	updatePages(0x00, 0xFE);
+}
+
+void MMU::copyToOAM(u8 source_page)
+{
+	// Sources above DFFF read WRAM through its echo
+	u8 page = source_page >= 0xE0 ? source_page - 0x20 : source_page;
+	u16 source = page << 8;
+
+	if (const u8* backing = m_read_backing[page])
+		memcpy(m_video.oam(), backing, VideoMemory::s_oam_size);
+	else {
+		for (size_t i = 0; i < VideoMemory::s_oam_size; ++i)
+			m_video.oam()[i] = m_cartridge->readRAM(source + i);
+	}
+
+	for (auto& dirty : m_dirty_sprites)
+		dirty.set();
+	markDirty(0xFE00);
+}
+
+void MMU::addWatchpoint(u16 begin, u16 end, u8 access)
+{
+	ASSERT(begin <= end);
+	m_watchpoints.push_back({ begin, end, access });
+
+	// Echo RAM reaches the same memory
+	for (unsigned page = begin >> 8; page <= (end >> 8u); ++page) {
+		m_watched_pages[page] |= access;
+		updatePage(page);
+		if (int mirror = mirrorPage(page); mirror >= 0) {
+			m_watched_pages[mirror] |= access;
+			updatePage(mirror);
+		}
+	}
+}
+
+void MMU::clearWatchpoints()
+{
+	m_watchpoints.clear();
+	m_watched_pages.fill(0);
+	updatePages(0x00, 0xFF);
+}
+
+void MMU::checkWatchpoints(WatchAccess access, u16 address, u8 value) const
+{
+	int mirror = mirrorPage(address >> 8);
+	u16 alias = mirror >= 0 ? (mirror << 8) | (address & 0xFF) : address;
+
+	for (const Watchpoint& watchpoint : m_watchpoints) {
+		bool hit = (watchpoint.begin <= address && address <= watchpoint.end) || (watchpoint.begin <= alias && alias <= watchpoint.end);
+		if ((watchpoint.access & access) && hit && m_watch_handler)
+			m_watch_handler(watchpoint, access, address, value);
+	}
 }
 
-void MMU::write8(u16 address, u8 value)
+void MMU::setTraceBuffer(TraceBuffer* trace)
 {
-	printf(YELLOW "WRITE " CYAN "[%04X]" RESET " <- " MAGENTA "%02X" RESET " (%s)\n", address, value, findRegion(address).name);
-	m_map[address] = value;
+	m_trace = trace;
+	updatePages(0x00, 0xFF);
 }
 
-void MMU::write16(u16 address, u16 value)
+bool MMU::attachSave(const std::string& filename)
 {
-	printf(YELLOW "WRITE " CYAN "[%04X]" RESET " <- " MAGENTA "%04X" RESET " (%s)\n", address, value, findRegion(address).name);
-	m_map[address] = value & 0xFF;
-	m_map[address + 1] = value >> 8;
+	if (!m_cartridge->attachSave(filename))
+		return false;
+	updatePages(0xA0, 0xBF);
+	return true;
 }
 
 bool MMU::testLogoHeader() const
 {
-	return memcmp(s_logo_header, slot(0x104), sizeof(s_logo_header)) == 0;
+	return m_cartridge->romSize() >= 0x150 && memcmp(s_logo_header, m_cartridge->rom() + 0x104, sizeof(s_logo_header)) == 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
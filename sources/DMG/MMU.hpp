@@ -7,16 +7,51 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "Cartridge.hpp"
+#include "TraceBuffer.hpp"
+#include "VideoMemory.hpp"
+#include "Utils/MappedFile.hpp"
 #include "Utils/Types.hpp"
 
 #include <array>
+#include <bitset>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DMG
 {
 
+// Notified when memory holding decoded code gets written to.
+class CodeObserver
+{
+public:
+	virtual ~CodeObserver() = default;
+	virtual void codeWritten(u16 address) = 0;
+};
+
+// Hardware registers living in the FF00-FFFF range.
+class IODevice
+{
+public:
+	virtual ~IODevice() = default;
+	virtual u8 readIO(u16 address) = 0;
+	virtual void writeIO(u16 address, u8 value) = 0;
+};
+
+// Memory is split in 256-byte pages. Pages holding plain memory have direct
+// pointers for reading and writing. Others hold null: I/O, OAM and ROM
+// writes, locked video memory, unmapped cartridge RAM and write-protected
+// code go through the slow handlers. Switching a bank only repoints the
+// pages of its window.
+//
+// Writes are tracked in dirty bitmaps: per page from 8000 up, per 16-byte
+// tile for VRAM and per sprite for OAM. Consumers clear the bits once they
+// caught up. Clean pages lose their direct write pointer so that the first
+// write sets their bit, VRAM writes always take the slow path.
 class MMU
 {
 public:
@@ -26,28 +61,181 @@ public:
 		const char* name;
 	};
 
+	enum WatchAccess : u8
+	{
+		WatchRead = 1 << 0,
+		WatchWrite = 1 << 1,
+	};
+
+	// Each consumer of the sprite bits catches up on its own schedule
+	enum SpriteConsumer : u8
+	{
+		SpriteIndexConsumer,
+		RenderThreadConsumer,
+		SpriteConsumers,
+	};
+
+	struct Watchpoint
+	{
+		u16 begin, end;
+		u8 access;
+	};
+
+	using WatchHandler = std::function<void(const Watchpoint&, WatchAccess, u16 address, u8 value)>;
+
 public:
-	MMU(const u8* rom_data, size_t rom_size);
+	explicit MMU(std::shared_ptr<const MappedFile> rom);
+
+	u8 read8(u16 address) const
+	{
+		if (const u8* page = m_read_pages[address >> 8])
+			return page[address & 0xFF];
+		return slowRead8(address);
+	}
+
+	void write8(u16 address, u8 value)
+	{
+		if (u8* page = m_write_pages[address >> 8])
+			page[address & 0xFF] = value;
+		else
+			slowWrite8(address, value);
+	}
 
-	u8 read8(u16 address) const;
-	u8 silent_read8(u16 address) const;
-	u16 read16(u16 address) const;
-	void write8(u16 address, u8);
-	void write16(u16 address, u16);
+	u16 read16(u16 address) const { return read8(address) | (read8(address + 1) << 8); }
+	void write16(u16 address, u16 value) { write8(address, value & 0xFF); write8(address + 1, value >> 8); }
 
-	u8& at(u16 address) { return m_map[address]; }
-	const u8* slot(u16 address) const { return &m_map[address]; }
-	u8* slot(u16 address) { return &m_map[address]; }
+	// Instruction stream reads see through the OAM DMA lock: code running
+	// outside HRAM during a transfer would crash on hardware, and blocks
+	// decoded beforehand could not honour the lock anyway.
+	u8 fetch8(u16 address) const
+	{
+		if (const u8* page = m_read_pages[address >> 8])
+			return page[address & 0xFF];
+		return slowRead8(address, true);
+	}
+
+	// Instruction fetches without tracing
+	u8 silent_read8(u16 address) const
+	{
+		if (const u8* page = m_read_pages[address >> 8])
+			return page[address & 0xFF];
+		return peek(address, true);
+	}
 
 	bool testLogoHeader() const;
 
+	// ROM bank currently mapped at an address below 8000
+	u16 romBank(u16 address) const { return m_cartridge->romBank(address); }
+	Cartridge& cartridge() { return *m_cartridge; }
+	// Keeps battery-backed cartridge RAM in a save file
+	bool attachSave(const std::string& filename);
+
+	void setCodeObserver(CodeObserver* observer) { m_code_observer = observer; }
+	void setCodePage(u8 page, bool has_code);
+
+	// Routes accesses to a high memory register to a device. Unmapped
+	// addresses behave as plain memory.
+	void mapIO(u16 address, IODevice* device) { m_io[address - 0xFF00] = device; }
+
+	// Data accesses to the inclusive [begin, end] range call the handler.
+	// Watched pages lose their direct pointers, so that only accesses to
+	// them take the slow path and get checked. Instruction fetches are left
+	// to breakpoints.
+	void addWatchpoint(u16 begin, u16 end, u8 access);
+	void clearWatchpoints();
+	void setWatchHandler(WatchHandler handler) { m_watch_handler = std::move(handler); }
+
+	// Echo RAM pages share the bit of the WRAM page they mirror
+	bool pageDirty(u8 page) const { return m_dirty_pages[canonicalPage(page)]; }
+	void clearDirtyPages(u8 first, u8 last);
+	const std::bitset<0x200>& dirtyTiles() const { return m_video.dirtyTiles(); }
+	void clearDirtyTiles() { m_video.clearDirtyTiles(); }
+	void clearDirtyTiles(u16 first, u16 last) { m_video.clearDirtyTiles(first, last); }
+	const std::bitset<40>& dirtySprites(SpriteConsumer consumer) const { return m_dirty_sprites[consumer]; }
+	void clearDirtySprites(SpriteConsumer consumer) { m_dirty_sprites[consumer].reset(); }
+
+	// Video memory as the PPU sees it, regardless of locks
+	VideoMemory& video() { return m_video; }
+	const u8* vram() const { return m_video.vram(); }
+	const u8* oam() const { return m_video.oam(); }
+
+	// The PPU locks VRAM while drawing and OAM while scanning or drawing
+	void setVRAMLocked(bool locked);
+	void setOAMLocked(bool locked);
+	// OAM DMA leaves the CPU with I/O registers and HRAM only
+	void setDMALocked(bool locked);
+	// Copies a page's first 160 bytes into OAM, as OAM DMA does
+	void copyToOAM(u8 source_page);
+
+	void setTraceBuffer(TraceBuffer* trace);
+
 	static const Region& findRegion(u16 address);
 
 private:
-	u8 m_map[0x10000] { 0 };
+	u8 slowRead8(u16 address, bool fetch = false) const;
+	void slowWrite8(u16 address, u8 value);
+	u8 peek(u16 address, bool fetch = false) const;
+	void poke(u16 address, u8 value);
+
+	// Memory backing a page, null for the FE and FF pages and unmapped
+	// cartridge RAM. ROM pages are read-only.
+	const u8* readBacking(u8 page);
+	u8* writeBacking(u8 page);
+	void updatePage(u8 page);
+	void updatePages(u8 first, u8 last);
+	void writeCartridgeRegister(u16 address, u8 value);
+	void markDirty(u16 address);
+	void checkWatchpoints(WatchAccess access, u16 address, u8 value) const;
+
+	void traceAccess(TraceRecord::Kind kind, u16 address, u8 value) const
+	{
+		TraceRecord record {};
+		record.kind = kind;
+		record.address = address;
+		record.value = value;
+		m_trace->push(record);
+	}
+
+	// Echo RAM pages and the WRAM pages they mirror, or -1
+	static int mirrorPage(u8 page)
+	{
+		if (page >= 0xC0 && page < 0xDE)
+			return page + 0x20;
+		if (page >= 0xE0 && page < 0xFE)
+			return page - 0x20;
+		return -1;
+	}
+
+	static u8 canonicalPage(u8 page) { return page >= 0xE0 && page < 0xFE ? page - 0x20 : page; }
+
+	std::array<const u8*, 0x100> m_read_backing {};
+	std::array<u8*, 0x100> m_write_backing {};
+	std::array<const u8*, 0x100> m_read_pages {};
+	std::array<u8*, 0x100> m_write_pages {};
+
+	std::unique_ptr<Cartridge> m_cartridge;
+	VideoMemory m_video;
+	u8 m_wram[0x2000] {};
+	u8 m_high[0x100] {}; // Unmapped I/O registers, HRAM and IE
+
+	bool m_vram_locked = false;
+	bool m_oam_locked = false;
+	bool m_dma_locked = false;
+
+	CodeObserver* m_code_observer = nullptr;
+	std::array<bool, 0x100> m_code_pages {};
+	std::bitset<0x100> m_dirty_pages;
+	std::array<std::bitset<40>, SpriteConsumers> m_dirty_sprites;
+	std::array<IODevice*, 0x100> m_io {};
+
+	TraceBuffer* m_trace = nullptr;
+
+	std::vector<Watchpoint> m_watchpoints;
+	std::array<u8, 0x100> m_watched_pages {}; // WatchAccess flags
+	WatchHandler m_watch_handler;
 
 	static const u8 s_logo_header[];
 	static const Region s_regions[];
 };
 
-}
\ No newline at end of file
+}
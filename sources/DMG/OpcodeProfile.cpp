@@ -0,0 +1,77 @@
+/*
+** Boi, 2020
+** DMG / OpcodeProfile.cpp
+*/
+
+#include "OpcodeProfile.hpp"
+#include "CPU.hpp"
+#include "Utils/Assertions.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OpcodeProfile::record(u16 opcode)
+{
+	if (m_recorded >= 1)
+		m_bigrams[(u32)m_previous[1] << 16 | opcode]++;
+	if (m_recorded >= 2)
+		m_trigrams[(u64)m_previous[0] << 32 | (u64)m_previous[1] << 16 | opcode]++;
+
+	m_previous[0] = m_previous[1];
+	m_previous[1] = opcode;
+	m_recorded++;
+}
+
+u64 OpcodeProfile::count(const u16* opcodes, size_t length) const
+{
+	auto find = [](const auto& counts, auto key) -> u64 {
+		auto it = counts.find(key);
+		return it != counts.end() ? it->second : 0;
+	};
+
+	ASSERT(length >= 2 && length <= 4);
+	if (length == 2)
+		return find(m_bigrams, (u32)opcodes[0] << 16 | opcodes[1]);
+	if (length == 3)
+		return find(m_trigrams, (u64)opcodes[0] << 32 | (u64)opcodes[1] << 16 | opcodes[2]);
+	return std::min(count(opcodes, 3), count(opcodes + 1, 3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename Map>
+static void printMostFrequent(std::ostream& os, const Map& counts, size_t length, size_t count)
+{
+	std::vector<std::pair<typename Map::key_type, u64>> sorted(counts.begin(), counts.end());
+	std::sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) { return a.second > b.second; });
+	sorted.resize(std::min(sorted.size(), count));
+
+	for (auto& [key, hits] : sorted) {
+		os << std::setw(12) << hits << "  ";
+		for (size_t i = length; i-- > 0;) {
+			u16 opcode = (key >> (16 * i)) & 0xFFFF;
+			os << CPU::mnemonic(opcode) << (i > 0 ? " ; " : "\n");
+		}
+	}
+}
+
+void OpcodeProfile::print(std::ostream& os, size_t count) const
+{
+	os << "Most frequent opcode pairs:\n";
+	printMostFrequent(os, m_bigrams, 2, count);
+	os << "Most frequent opcode triplets:\n";
+	printMostFrequent(os, m_trigrams, 3, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,42 @@
+/*
+** Boi, 2020
+** DMG / OpcodeProfile.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/Types.hpp"
+
+#include <iosfwd>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Counts the opcode pairs and triplets a ROM executes, to pick the
+// sequences worth fusing into superinstructions.
+class OpcodeProfile
+{
+public:
+	// Opcodes are keyed 0000-00FF, prefixed ones CB00-CBFF
+	void record(u16 opcode);
+	void print(std::ostream&, size_t count) const;
+
+	u64 recorded() const { return m_recorded; }
+	// Sequences of 4 get the count of the least frequent of their triplets,
+	// an upper bound
+	u64 count(const u16* opcodes, size_t length) const;
+
+private:
+	u16 m_previous[2] {};
+	u64 m_recorded = 0;
+
+	std::unordered_map<u32, u64> m_bigrams;
+	std::unordered_map<u64, u64> m_trigrams;
+};
+
+}
@@ -0,0 +1,290 @@
+/*
+** Boi, 2020
+** DMG / PPU.cpp
+*/
+
+#include "PPU.hpp"
+#include "FIFORenderer.hpp"
+#include "ScanlineRenderer.hpp"
+#include "ThreadedRenderer.hpp"
+#include "Utils/Assertions.hpp"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+PPU::PPU(Scheduler& scheduler, CPU& cpu, MMU& mmu, Engine engine)
+: m_scheduler(scheduler)
+, m_cpu(cpu)
+, m_mmu(mmu)
+, m_engine(engine)
+, m_renderer(rendererFactory(engine)(mmu.video()))
+, m_sprite_index(mmu)
+{
+	if (engine == Engine::PixelFIFO)
+		m_pipeline = std::make_unique<PixelPipeline>(mmu.video());
+
+	for (u16 address : { 0xFF40, 0xFF41, 0xFF42, 0xFF43, 0xFF44, 0xFF45, 0xFF47, 0xFF48, 0xFF49, 0xFF4A, 0xFF4B })
+		m_mmu.mapIO(address, this);
+
+	m_scheduler.setHandler(Event::PPUMode, [this](u64 timestamp) { step(timestamp); });
+	enterMode(Mode::OAMScan, m_scheduler.now());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+u8 PPU::readIO(u16 address)
+{
+	switch (address) {
+		case 0xFF40: return m_registers.lcdc;
+		case 0xFF41: return 0x80 | m_stat | (m_ly == m_lyc ? 0x04 : 0) | static_cast<u8>(m_mode);
+		case 0xFF42: return m_registers.scy;
+		case 0xFF43: return m_registers.scx;
+		case 0xFF44: return m_ly;
+		case 0xFF45: return m_lyc;
+		case 0xFF47: return m_registers.bgp;
+		case 0xFF48: return m_registers.obp0;
+		case 0xFF49: return m_registers.obp1;
+		case 0xFF4A: return m_registers.wy;
+		case 0xFF4B: return m_registers.wx;
+	}
+	ASSERT_NOT_REACHED();
+}
+
+void PPU::writeIO(u16 address, u8 value)
+{
+	// The part of the line drawn so far uses the previous values
+	if (m_mode == Mode::Transfer && address != 0xFF41 && address != 0xFF44 && address != 0xFF45) {
+		if (m_pipeline)
+			m_pipeline->advance(m_registers, m_scheduler.now() - m_transfer_start, nullptr);
+		if (m_rendering)
+			m_renderer->advance(m_registers, m_scheduler.now());
+	}
+
+	switch (address) {
+		case 0xFF40: {
+			bool was_enabled = enabled();
+			m_registers.lcdc = value;
+			if (was_enabled && !enabled()) {
+				m_scheduler.cancel(Event::PPUMode);
+				m_ly = 0;
+				m_mode = Mode::HBlank;
+				m_mmu.setVRAMLocked(false);
+				m_mmu.setOAMLocked(false);
+				m_renderer->clear();
+			}
+			else if (!was_enabled && enabled())
+				enterMode(Mode::OAMScan, m_scheduler.now());
+			retimeTransfer();
+			break;
+		}
+		case 0xFF41:
+			m_stat = value & 0x78;
+			break;
+		case 0xFF42:
+			m_registers.scy = value;
+			return;
+		case 0xFF43:
+			m_registers.scx = value;
+			return;
+		case 0xFF44:
+			// Read-only
+			return;
+		case 0xFF45:
+			m_lyc = value;
+			break;
+		case 0xFF47:
+			m_registers.bgp = value;
+			return;
+		case 0xFF48:
+			m_registers.obp0 = value;
+			return;
+		case 0xFF49:
+			m_registers.obp1 = value;
+			return;
+		case 0xFF4A:
+			m_registers.wy = value;
+			retimeTransfer();
+			return;
+		case 0xFF4B:
+			m_registers.wx = value;
+			retimeTransfer();
+			return;
+		default:
+			ASSERT_NOT_REACHED();
+	}
+
+	if (enabled())
+		updateStatLine();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PPU::step(u64 timestamp)
+{
+	switch (m_mode) {
+		case Mode::OAMScan:
+			enterMode(Mode::Transfer, timestamp);
+			break;
+		case Mode::Transfer:
+			if (m_pipeline) {
+				m_pipeline->finish(m_registers, nullptr);
+				m_pipeline->endLine();
+			}
+			if (m_rendering)
+				m_renderer->endLine(m_registers, timestamp);
+			enterMode(Mode::HBlank, timestamp);
+			break;
+		case Mode::HBlank:
+			++m_ly;
+			enterMode(m_ly == s_visible_lines ? Mode::VBlank : Mode::OAMScan, timestamp);
+			break;
+		case Mode::VBlank:
+			if (++m_ly == s_lines) {
+				m_ly = 0;
+				enterMode(Mode::OAMScan, timestamp);
+			}
+			else {
+				m_scheduler.schedule(Event::PPUMode, timestamp + s_cycles_per_line);
+				updateStatLine();
+			}
+			break;
+	}
+}
+
+void PPU::enterMode(Mode mode, u64 timestamp)
+{
+	m_mode = mode;
+	m_mmu.setVRAMLocked(mode == Mode::Transfer);
+	m_mmu.setOAMLocked(mode == Mode::OAMScan || mode == Mode::Transfer);
+
+	switch (mode) {
+		case Mode::OAMScan:
+			if (m_ly == 0) {
+				m_rendering = !m_render_skipping || m_frame_requested;
+				m_frame_requested = false;
+			}
+			m_scheduler.schedule(Event::PPUMode, timestamp + s_oam_scan_cycles);
+			break;
+		case Mode::Transfer:
+			scanOAM();
+			m_transfer_start = timestamp;
+			if (m_rendering)
+				m_renderer->beginLine(m_ly, m_registers, m_sprites, timestamp);
+			if (m_pipeline) {
+				m_pipeline->beginLine(m_ly, m_registers, m_sprites);
+				retimeTransfer();
+				break;
+			}
+			m_transfer_cycles = transferCycles();
+			m_scheduler.schedule(Event::PPUMode, timestamp + m_transfer_cycles);
+			break;
+		case Mode::HBlank:
+			m_scheduler.schedule(Event::PPUMode, timestamp + s_cycles_per_line - s_oam_scan_cycles - m_transfer_cycles);
+			break;
+		case Mode::VBlank:
+			if (m_rendering && m_render_skipping)
+				m_frame_ready = true;
+			m_cpu.requestInterrupt(Interrupt::VBlank);
+			m_scheduler.schedule(Event::PPUMode, timestamp + s_cycles_per_line);
+			break;
+	}
+
+	updateStatLine();
+}
+
+void PPU::enableRenderThread()
+{
+	// The new renderer starts with a blank screen, and draws the line in
+	// progress from its start with the current registers
+	m_renderer = std::make_unique<ThreadedRenderer>(m_mmu, rendererFactory(m_engine));
+	if (m_mode == Mode::Transfer && m_rendering)
+		m_renderer->beginLine(m_ly, m_registers, m_sprites, m_transfer_start);
+}
+
+Renderer::Factory PPU::rendererFactory(Engine engine)
+{
+	if (engine == Engine::PixelFIFO)
+		return [](VideoMemory& video) -> std::unique_ptr<Renderer> { return std::make_unique<FIFORenderer>(video); };
+	return [](VideoMemory& video) -> std::unique_ptr<Renderer> { return std::make_unique<ScanlineRenderer>(video); };
+}
+
+void PPU::requestFrame()
+{
+	m_frame_requested = true;
+	m_frame_ready = false;
+}
+
+void PPU::scanOAM()
+{
+	m_sprite_index.update(m_registers.lcdc & 0x04 ? 16 : 8);
+	m_sprite_index.select(m_ly, m_sprites);
+}
+
+u32 PPU::transferCycles() const
+{
+	// Fine scrolling drops the first pixels of the line after fetching them
+	u32 cycles = s_transfer_cycles + (m_registers.scx & 0x07);
+
+	// Restarting the fetcher on the window
+	if ((m_registers.lcdc & 0x21) == 0x21 && m_ly >= m_registers.wy && m_registers.wx <= 166)
+		cycles += 6;
+
+	if (!(m_registers.lcdc & 0x02))
+		return cycles;
+
+	// Fetching a sprite takes 6 dots, plus waiting for the background fetch
+	// under its left edge to end, for the leftmost sprite of each tile
+	const u8* oam = m_mmu.oam();
+	u32 waited_tiles = 0;
+	for (u8 i = 0; i < m_sprites.count; ++i) {
+		u8 x = oam[m_sprites.indices[i] * 4 + 1];
+		if (x >= 168)
+			continue;
+		if (x == 0) {
+			cycles += 11;
+			continue;
+		}
+
+		u16 pixel = x + (m_registers.scx & 0x07);
+		u32 tile = 1u << (pixel / 8);
+		cycles += 6;
+		if (!(waited_tiles & tile))
+			cycles += std::max(0, 5 - (pixel & 0x07));
+		waited_tiles |= tile;
+	}
+	return cycles;
+}
+
+void PPU::retimeTransfer()
+{
+	if (!m_pipeline || m_mode != Mode::Transfer)
+		return;
+
+	// Runs a copy to the end of the line, assuming no more register writes
+	PixelPipeline end = *m_pipeline;
+	end.finish(m_registers, nullptr);
+	m_transfer_cycles = end.dot();
+	m_scheduler.schedule(Event::PPUMode, m_transfer_start + m_transfer_cycles);
+}
+
+void PPU::updateStatLine()
+{
+	bool line = ((m_stat & 0x40) && m_ly == m_lyc)
+		|| ((m_stat & 0x20) && m_mode == Mode::OAMScan)
+		|| ((m_stat & 0x10) && m_mode == Mode::VBlank)
+		|| ((m_stat & 0x08) && m_mode == Mode::HBlank);
+
+	if (line && !m_stat_line)
+		m_cpu.requestInterrupt(Interrupt::LCDStat);
+	m_stat_line = line;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
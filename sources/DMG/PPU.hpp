@@ -0,0 +1,117 @@
+/*
+** Boi, 2020
+** DMG / PPU.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "CPU.hpp"
+#include "MMU.hpp"
+#include "PixelPipeline.hpp"
+#include "Renderer.hpp"
+#include "Scheduler.hpp"
+#include "SpriteIndex.hpp"
+#include "Utils/Types.hpp"
+
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// LCD timing: mode changes are scheduled events, LY and STAT are only updated
+// when one of them fires. The renderer draws each line during its transfer.
+//
+// The scanline engine gives the transfer a length computed from the line at
+// its start. The pixel FIFO one runs a pipeline of its own without drawing,
+// and ends the transfer when it outputs the last pixel of the line, looking
+// ahead again whenever a register write could change when that happens.
+class PPU final : public IODevice
+{
+public:
+	enum class Engine
+	{
+		Scanline,
+		PixelFIFO,
+	};
+
+	enum class Mode : u8
+	{
+		HBlank = 0,
+		VBlank = 1,
+		OAMScan = 2,
+		Transfer = 3,
+	};
+
+public:
+	PPU(Scheduler&, CPU&, MMU&, Engine = Engine::Scanline);
+
+	u8 readIO(u16 address) override;
+	void writeIO(u16 address, u8 value) override;
+
+	Mode mode() const { return m_mode; }
+	u8 ly() const { return m_ly; }
+	bool enabled() const { return m_registers.lcdc & 0x80; }
+	const u8* framebuffer() const { return m_renderer->framebuffer(); }
+
+	// Moves drawing to a thread of its own, fed with the registers and video
+	// memory changes of each line. Timing and pixels don't change.
+	void enableRenderThread();
+
+	// Without rendering, the timing, registers and interrupts are unchanged
+	// but the framebuffer is only drawn for requested frames. A request
+	// applies to the next frame starting, frameReady() tells when it's done.
+	void setRenderSkipping(bool skipping) { m_render_skipping = skipping; }
+	void requestFrame();
+	bool frameReady() const { return m_frame_ready; }
+
+	static constexpr u32 s_cycles_per_line = 456;
+	static constexpr u32 s_oam_scan_cycles = 80;
+	// Without scrolling, window or sprites
+	static constexpr u32 s_transfer_cycles = 172;
+	static constexpr u8 s_visible_lines = 144;
+	static constexpr u8 s_lines = 154;
+
+private:
+	void step(u64 timestamp);
+	void enterMode(Mode, u64 timestamp);
+	static Renderer::Factory rendererFactory(Engine);
+
+	void updateStatLine();
+	void scanOAM();
+	u32 transferCycles() const;
+	void retimeTransfer();
+
+	Scheduler& m_scheduler;
+	CPU& m_cpu;
+	MMU& m_mmu;
+
+	Engine m_engine;
+	std::unique_ptr<Renderer> m_renderer;
+	// Timing of the transfer, with the pixel FIFO engine only
+	std::unique_ptr<PixelPipeline> m_pipeline;
+	SpriteIndex m_sprite_index;
+
+	Mode m_mode = Mode::OAMScan;
+	LCDRegisters m_registers;
+	LineSprites m_sprites;
+	u64 m_transfer_start = 0;
+	u32 m_transfer_cycles = s_transfer_cycles;
+	u8 m_stat = 0x00; // Only the interrupt selection bits
+	u8 m_ly = 0;
+	u8 m_lyc = 0;
+
+	// STAT interrupts fire on rising edges of the ORed sources
+	bool m_stat_line = false;
+
+	bool m_render_skipping = false;
+	bool m_frame_requested = false;
+	bool m_frame_ready = false;
+	// Whether the current frame gets drawn
+	bool m_rendering = true;
+};
+
+}
@@ -0,0 +1,239 @@
+/*
+** Boi, 2020
+** DMG / PixelPipeline.cpp
+*/
+
+#include "PixelPipeline.hpp"
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Fetcher steps take 2 dots each: tile number, low byte, high byte, push
+static constexpr u8 s_fetch_tile = 1;
+static constexpr u8 s_fetch_low = 3;
+static constexpr u8 s_fetch_high = 5;
+static constexpr u8 s_fetch_push = 6;
+
+static constexpr u8 s_sprite_fetch_dots = 6;
+
+static u8 bit(u8 low, u8 high, u8 x)
+{
+	return ((low >> (7 - x)) & 1) | (((high >> (7 - x)) & 1) << 1);
+}
+
+PixelPipeline::PixelPipeline(const VideoMemory& video)
+: m_video(&video)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixelPipeline::beginLine(u8 ly, const LCDRegisters& registers, const LineSprites& sprites)
+{
+	if (ly == 0)
+		m_window_line = 0;
+
+	m_ly = ly;
+	m_dot = 0;
+	m_x = 0;
+	m_discard = registers.scx & 0x07;
+	m_fifo_size = 0;
+	m_first_fetch = true;
+	m_fetch_step = 0;
+	m_fetch_x = 0;
+	m_in_window = false;
+
+	const u8* oam = m_video->oam();
+	m_sprite_count = sprites.count;
+	m_next_sprite = 0;
+	m_sprite_fetch = 0;
+	for (u8 i = 0; i < sprites.count; ++i) {
+		m_sprite_index[i] = sprites.indices[i];
+		m_sprite_x[i] = oam[sprites.indices[i] * 4 + 1];
+	}
+	memset(m_sprite_pixels, 0, sizeof(m_sprite_pixels));
+}
+
+void PixelPipeline::advance(const LCDRegisters& registers, u32 dot, u8* line)
+{
+	while (m_dot < dot && !done())
+		tick(registers, line);
+}
+
+void PixelPipeline::endLine()
+{
+	if (m_in_window)
+		++m_window_line;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixelPipeline::tick(const LCDRegisters& registers, u8* line)
+{
+	++m_dot;
+
+	if (m_sprite_fetch > 0) {
+		if (--m_sprite_fetch == 0)
+			fetchSprite(registers, line != nullptr);
+		return;
+	}
+
+	while (spriteDue()) {
+		// Disabled sprites are passed without stopping
+		if (!(registers.lcdc & 0x02)) {
+			++m_next_sprite;
+			continue;
+		}
+
+		// The background fetch gets its tile data first
+		if (m_fetch_step < s_fetch_high) {
+			fetch(registers, line != nullptr);
+			return;
+		}
+
+		m_sprite_fetch = s_sprite_fetch_dots - 1;
+		return;
+	}
+
+	if (m_fifo_size > 0) {
+		if (windowStarts(registers))
+			startWindow(registers);
+		else {
+			u8 color = m_fifo[8 - m_fifo_size--];
+			if (m_discard > 0)
+				--m_discard;
+			else {
+				if (line)
+					line[m_x] = shade(color, registers);
+				++m_x;
+			}
+		}
+	}
+
+	if (m_fetch_step < s_fetch_push)
+		fetch(registers, line != nullptr);
+	if (m_fetch_step == s_fetch_push && m_fifo_size == 0) {
+		m_fetch_step = 0;
+
+		// The first fetch of the line is thrown away
+		if (m_first_fetch) {
+			m_first_fetch = false;
+			return;
+		}
+
+		for (u8 x = 0; x < 8; ++x)
+			m_fifo[x] = bit(m_tile_low, m_tile_high, x);
+		m_fifo_size = 8;
+		++m_fetch_x;
+	}
+}
+
+void PixelPipeline::fetch(const LCDRegisters& registers, bool draw)
+{
+	u8 step = m_fetch_step++;
+	if (!draw)
+		return;
+
+	switch (step) {
+		case s_fetch_tile: {
+			u16 map = m_in_window ? (registers.lcdc & 0x40 ? 0x1C00 : 0x1800) : (registers.lcdc & 0x08 ? 0x1C00 : 0x1800);
+			u8 y = m_in_window ? m_window_line : registers.scy + m_ly;
+			u8 x = m_in_window ? m_fetch_x : (registers.scx >> 3) + m_fetch_x;
+			m_tile = m_video->vram()[map + (y / 8) * 32 + (x & 0x1F)];
+			break;
+		}
+		case s_fetch_low:
+		case s_fetch_high: {
+			// Tile data is addressed from 8000, or signed from 9000
+			u16 tile = registers.lcdc & 0x10 ? m_tile : 256 + static_cast<i8>(m_tile);
+			u8 y = m_in_window ? m_window_line : registers.scy + m_ly;
+			const u8* data = m_video->vram() + tile * 16 + (y % 8) * 2;
+			if (step == s_fetch_low)
+				m_tile_low = data[0];
+			else
+				m_tile_high = data[1];
+			break;
+		}
+	}
+}
+
+bool PixelPipeline::spriteDue() const
+{
+	if (m_next_sprite == m_sprite_count || m_fifo_size == 0)
+		return false;
+
+	// Sprites cut by the left edge are fetched before any pixel is dropped,
+	// the others once the FIFO reaches their first pixel
+	u8 x = m_sprite_x[m_next_sprite];
+	return x < 8 || (m_discard == 0 && x <= m_x + 8);
+}
+
+void PixelPipeline::fetchSprite(const LCDRegisters& registers, bool draw)
+{
+	u8 index = m_sprite_index[m_next_sprite++];
+	if (!draw)
+		return;
+
+	const u8* entry = m_video->oam() + index * 4;
+	const u8 height = registers.lcdc & 0x04 ? 16 : 8;
+	const u8 flags = entry[3];
+
+	u8 y = (m_ly + 16 - entry[0]) & (height - 1);
+	if (flags & 0x40)
+		y = height - 1 - y;
+	u8 tile = height == 16 ? (entry[2] & 0xFE) + y / 8 : entry[2];
+	const u8* data = m_video->vram() + tile * 16 + (y % 8) * 2;
+
+	for (u8 column = 0; column < 8; ++column) {
+		int x = entry[1] - 8 + column;
+		if (x < 0 || x >= Renderer::s_width || m_sprite_pixels[x] != 0)
+			continue;
+		u8 color = bit(data[0], data[1], flags & 0x20 ? 7 - column : column);
+		if (color != 0)
+			m_sprite_pixels[x] = color | (flags & 0x90);
+	}
+}
+
+bool PixelPipeline::windowStarts(const LCDRegisters& registers) const
+{
+	// WX is offset by 7, the window may start left of the screen
+	return !m_in_window
+		&& (registers.lcdc & 0x21) == 0x21
+		&& m_ly >= registers.wy
+		&& registers.wx <= 166
+		&& m_x + 7 >= registers.wx;
+}
+
+void PixelPipeline::startWindow(const LCDRegisters& registers)
+{
+	// The fetcher restarts from the first tile of the window
+	m_in_window = true;
+	m_fifo_size = 0;
+	m_fetch_step = 0;
+	m_fetch_x = 0;
+	m_discard = registers.wx < 7 ? 7 - registers.wx : 0;
+}
+
+u8 PixelPipeline::shade(u8 color, const LCDRegisters& registers) const
+{
+	// Without BG, the window is off too and sprites always win
+	if (!(registers.lcdc & 0x01))
+		color = 0;
+
+	u8 sprite = m_sprite_pixels[m_x];
+	if ((sprite & 0x03) && (registers.lcdc & 0x02) && (!(sprite & 0x80) || color == 0)) {
+		u8 palette = sprite & 0x10 ? registers.obp1 : registers.obp0;
+		return (palette >> ((sprite & 0x03) * 2)) & 0x03;
+	}
+	return (registers.bgp >> (color * 2)) & 0x03;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
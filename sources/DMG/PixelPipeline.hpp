@@ -0,0 +1,90 @@
+/*
+** Boi, 2020
+** DMG / PixelPipeline.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Renderer.hpp"
+#include "VideoMemory.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Fetcher and pixel FIFO of the PPU, stepped one dot at a time. A fetcher
+// reads tile rows into the FIFO, which shifts one pixel out per dot. The
+// first tile fetched on a line is thrown away, so the first pixel comes out
+// on dot 12. Reaching a sprite stops the FIFO until the background fetch in
+// progress got its tile data, then for the 6 dots of the sprite fetch. Mode
+// 3 ends once the last pixel is out.
+//
+// The registers are sampled when the fetcher or the FIFO use them, so
+// changes made in the middle of a line show from the next tile (scroll,
+// LCDC) or pixel (palettes) onwards. Without a line to draw into, only the
+// timing is kept and video memory isn't read.
+class PixelPipeline
+{
+public:
+	explicit PixelPipeline(const VideoMemory&);
+
+	// Sprites are taken in priority order, which is by X first
+	void beginLine(u8 ly, const LCDRegisters&, const LineSprites&);
+	// Runs until the given dot of the line, or its end
+	void advance(const LCDRegisters&, u32 dot, u8* line);
+	void finish(const LCDRegisters& registers, u8* line) { advance(registers, UINT32_MAX, line); }
+	// The window line only advances on lines showing the window
+	void endLine();
+
+	u32 dot() const { return m_dot; }
+	bool done() const { return m_x == Renderer::s_width; }
+
+private:
+	void tick(const LCDRegisters&, u8* line);
+	void fetch(const LCDRegisters&, bool draw);
+	bool spriteDue() const;
+	void fetchSprite(const LCDRegisters&, bool draw);
+	bool windowStarts(const LCDRegisters&) const;
+	void startWindow(const LCDRegisters&);
+	u8 shade(u8 color, const LCDRegisters&) const;
+
+	// A pointer, so that the state of a line can be copied to look ahead
+	const VideoMemory* m_video;
+
+	u8 m_ly = 0;
+	u32 m_dot = 0;
+	// Next pixel on the screen, and pixels to drop before it
+	u8 m_x = Renderer::s_width;
+	u8 m_discard = 0;
+
+	// The fetcher only pushes a tile row once the FIFO is empty
+	u8 m_fifo[8] {};
+	u8 m_fifo_size = 0;
+
+	bool m_first_fetch = false;
+	u8 m_fetch_step = 0;
+	u8 m_fetch_x = 0;
+	u8 m_tile = 0;
+	u8 m_tile_low = 0;
+	u8 m_tile_high = 0;
+
+	bool m_in_window = false;
+	// Line of the window to draw next
+	u8 m_window_line = 0;
+
+	// OAM X and index of the sprites of the line, as found by the OAM scan
+	u8 m_sprite_x[LineSprites::s_max] {};
+	u8 m_sprite_index[LineSprites::s_max] {};
+	u8 m_sprite_count = 0;
+	u8 m_next_sprite = 0;
+	u8 m_sprite_fetch = 0; // Dots left
+	// Color of the sprite pixel over each one of the line, with the palette
+	// and priority bits of its attributes. The first opaque one wins.
+	u8 m_sprite_pixels[Renderer::s_width] {};
+};
+
+}
@@ -0,0 +1,75 @@
+/*
+** Boi, 2020
+** DMG / Renderer.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoMemory.hpp"
+#include "Utils/Types.hpp"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// PPU registers affecting what gets drawn
+struct LCDRegisters
+{
+	u8 lcdc = 0x91;
+	u8 scy = 0x00;
+	u8 scx = 0x00;
+	u8 bgp = 0xFC;
+	u8 obp0 = 0xFF;
+	u8 obp1 = 0xFF;
+	u8 wy = 0x00;
+	u8 wx = 0x00;
+};
+
+// Sprites picked by the OAM scan for a line: the first 10 covering it by OAM
+// index, in drawing priority order (leftmost first, then lowest OAM index)
+struct LineSprites
+{
+	static constexpr u8 s_max = 10;
+
+	u8 count = 0;
+	u8 indices[s_max];
+};
+
+// Draws the lines of the LCD while the PPU transfers them. The PPU keeps the
+// timing, the renderer gets the registers at the start and end of each
+// transfer and right before they change during one.
+class Renderer
+{
+public:
+	static constexpr u8 s_width = 160;
+	static constexpr u8 s_height = 144;
+
+	// Builds a renderer drawing from the given video memory
+	using Factory = std::function<std::unique_ptr<Renderer>(VideoMemory&)>;
+
+public:
+	virtual ~Renderer() = default;
+
+	virtual void beginLine(u8 ly, const LCDRegisters&, const LineSprites&, u64 timestamp) = 0;
+	// Draws up to the given time with the registers before they change
+	virtual void advance(const LCDRegisters&, u64 timestamp) = 0;
+	virtual void endLine(const LCDRegisters&, u64 timestamp) = 0;
+
+	virtual void clear() { memset(m_framebuffer, 0, sizeof(m_framebuffer)); }
+
+	// Shades from 0 (white) to 3 (black), row by row, with every line the
+	// renderer was given drawn
+	virtual const u8* framebuffer() { return &m_framebuffer[0][0]; }
+
+protected:
+	u8 m_framebuffer[s_height][s_width] {};
+};
+
+}
@@ -0,0 +1,113 @@
+/*
+** Boi, 2020
+** DMG / ScanlineRenderer.cpp
+*/
+
+#include "ScanlineRenderer.hpp"
+#include "TileDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+ScanlineRenderer::ScanlineRenderer(VideoMemory& video)
+: m_video(video)
+, m_tiles(video)
+, m_maps(video, m_tiles)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ScanlineRenderer::renderLine(u8 ly, const LCDRegisters& registers)
+{
+	if (ly == 0)
+		m_window_line = 0;
+
+	m_maps.update();
+	m_tiles.update();
+
+	// Without BG, the window is off too and sprites always win
+	if (registers.lcdc & 0x01) {
+		renderBackground(ly, registers);
+		renderWindow(ly, registers);
+	}
+	else
+		memset(m_line, 0, sizeof(m_line));
+
+	TileDecoder::applyPalette(m_line, registers.bgp, m_framebuffer[ly], s_width);
+
+	if (registers.lcdc & 0x02)
+		renderSprites(ly, registers);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ScanlineRenderer::renderBackground(u8 ly, const LCDRegisters& registers)
+{
+	const u8* row = m_maps.row(registers.lcdc & 0x08, registers.lcdc & 0x10, registers.scy + ly);
+
+	// The map wraps around horizontally
+	u16 first = std::min<u16>(s_width, TileMapCache::s_size - registers.scx);
+	memcpy(m_line, row + registers.scx, first);
+	memcpy(m_line + first, row, s_width - first);
+}
+
+void ScanlineRenderer::renderWindow(u8 ly, const LCDRegisters& registers)
+{
+	if (!(registers.lcdc & 0x20) || ly < registers.wy || registers.wx > 166)
+		return;
+
+	const u8* row = m_maps.row(registers.lcdc & 0x40, registers.lcdc & 0x10, m_window_line++);
+
+	// WX is offset by 7, the window may start left of the screen
+	int left = registers.wx - 7;
+	int x = std::max(left, 0);
+	memcpy(m_line + x, row + (x - left), s_width - x);
+}
+
+void ScanlineRenderer::renderSprites(u8 ly, const LCDRegisters& registers)
+{
+	const u8* oam = m_video.oam();
+	const u8 height = registers.lcdc & 0x04 ? 16 : 8;
+	const u8* sprites = m_sprites.indices;
+	const u8 count = m_sprites.count;
+
+	// Sprites come in priority order, the first drawn over a pixel wins
+	bool covered[s_width] {};
+	u8* pixels = m_framebuffer[ly];
+	for (u8 i = 0; i < count; ++i) {
+		const u8* sprite = oam + sprites[i] * 4;
+		u8 flags = sprite[3];
+		u8 y = ly - (sprite[0] - 16);
+		if (flags & 0x40)
+			y = height - 1 - y;
+
+		u8 tile = height == 16 ? (sprite[2] & 0xFE) + y / 8 : sprite[2];
+		const u8* row = m_tiles.row(tile, y % 8);
+		u8 palette = flags & 0x10 ? registers.obp1 : registers.obp0;
+
+		for (u8 column = 0; column < 8; ++column) {
+			int x = sprite[1] - 8 + column;
+			u8 color = row[flags & 0x20 ? 7 - column : column];
+			if (x < 0 || x >= s_width || color == 0 || covered[x])
+				continue;
+
+			// Pixels of higher priority sprites hide these even when they
+			// end up behind the background
+			covered[x] = true;
+			if (!(flags & 0x80) || m_line[x] == 0)
+				pixels[x] = (palette >> (color * 2)) & 0x03;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
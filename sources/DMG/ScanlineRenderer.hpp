@@ -0,0 +1,55 @@
+/*
+** Boi, 2020
+** DMG / ScanlineRenderer.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoMemory.hpp"
+#include "Renderer.hpp"
+#include "TileCache.hpp"
+#include "TileMapCache.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Draws whole lines at once from the registers' values at the end of the
+// transfer. Background and window lines are copied out of the drawn tile
+// maps, sprites read the decoded tile cache. Changes made to the registers in
+// the middle of a line are not seen.
+class ScanlineRenderer final : public Renderer
+{
+public:
+	explicit ScanlineRenderer(VideoMemory&);
+
+	void beginLine(u8 ly, const LCDRegisters&, const LineSprites& sprites, u64) override { m_ly = ly; m_sprites = sprites; }
+	void advance(const LCDRegisters&, u64) override {}
+	void endLine(const LCDRegisters& registers, u64) override { renderLine(m_ly, registers); }
+
+	void renderLine(u8 ly, const LCDRegisters&);
+
+private:
+	void renderBackground(u8 ly, const LCDRegisters&);
+	void renderWindow(u8 ly, const LCDRegisters&);
+	void renderSprites(u8 ly, const LCDRegisters&);
+
+	VideoMemory& m_video;
+	TileCache m_tiles;
+	TileMapCache m_maps;
+
+	u8 m_ly = 0;
+	LineSprites m_sprites;
+
+	// Background and window color indices of the current line, before the
+	// palette, for sprite priority
+	u8 m_line[s_width];
+	// Line of the window to draw next, it only advances on lines showing it
+	u8 m_window_line = 0;
+};
+
+}
@@ -0,0 +1,73 @@
+/*
+** Boi, 2020
+** DMG / Scheduler.cpp
+*/
+
+#include "Scheduler.hpp"
+#include "Utils/Assertions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+Scheduler::Scheduler(const u64& clock)
+: m_clock(clock)
+{
+	m_timestamps.fill(s_never);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Scheduler::setHandler(Event event, Handler handler)
+{
+	m_handlers[index(event)] = std::move(handler);
+}
+
+void Scheduler::schedule(Event event, u64 timestamp)
+{
+	ASSERT(timestamp != s_never);
+	m_timestamps[index(event)] = timestamp;
+	m_queue.push({ timestamp, event });
+
+	if (m_scheduled_handler)
+		m_scheduled_handler(timestamp);
+}
+
+void Scheduler::cancel(Event event)
+{
+	m_timestamps[index(event)] = s_never;
+}
+
+u64 Scheduler::nextDeadline() const
+{
+	dropStaleEntries();
+	return m_queue.empty() ? s_never : m_queue.top().timestamp;
+}
+
+void Scheduler::dispatch()
+{
+	while (nextDeadline() <= now()) {
+		Entry entry = m_queue.top();
+		m_queue.pop();
+		m_timestamps[index(entry.event)] = s_never;
+
+		auto& handler = m_handlers[index(entry.event)];
+		ASSERT(handler != nullptr);
+		handler(entry.timestamp);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Scheduler::dropStaleEntries() const
+{
+	while (!m_queue.empty() && m_queue.top().timestamp != m_timestamps[index(m_queue.top().event)])
+		m_queue.pop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
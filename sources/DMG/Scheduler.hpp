@@ -0,0 +1,86 @@
+/*
+** Boi, 2020
+** DMG / Scheduler.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/Types.hpp"
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+enum class Event : u8
+{
+	PPUMode,
+	TimerOverflow,
+	SerialTransfer,
+	OAMDMA,
+	Count,
+};
+
+// Min-heap of timestamped device events. Every event kind has at most one
+// occurrence pending: scheduling it again replaces the previous one.
+class Scheduler
+{
+public:
+	using Handler = std::function<void(u64 timestamp)>;
+
+	static constexpr u64 s_never = std::numeric_limits<u64>::max();
+
+public:
+	explicit Scheduler(const u64& clock);
+
+	u64 now() const { return m_clock; }
+
+	void setHandler(Event, Handler);
+	// Called with the timestamp of every scheduled event, so that the
+	// current run can end before it
+	void setScheduledHandler(Handler handler) { m_scheduled_handler = std::move(handler); }
+	void schedule(Event, u64 timestamp);
+	void cancel(Event);
+	bool isScheduled(Event event) const { return m_timestamps[index(event)] != s_never; }
+	u64 timestampOf(Event event) const { return m_timestamps[index(event)]; }
+
+	u64 nextDeadline() const;
+	// Runs the handlers of every event due by now(), in timestamp order
+	void dispatch();
+
+private:
+	struct Entry
+	{
+		u64 timestamp;
+		Event event;
+
+		bool operator>(const Entry& other) const
+		{
+			if (timestamp != other.timestamp)
+				return timestamp > other.timestamp;
+			return event > other.event;
+		}
+	};
+
+	static constexpr size_t index(Event event) { return static_cast<size_t>(event); }
+
+	void dropStaleEntries() const;
+
+	const u64& m_clock;
+
+	// Entries that don't match m_timestamps were cancelled or rescheduled
+	mutable std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> m_queue;
+	std::array<u64, static_cast<size_t>(Event::Count)> m_timestamps;
+	std::array<Handler, static_cast<size_t>(Event::Count)> m_handlers;
+	Handler m_scheduled_handler;
+};
+
+}
@@ -0,0 +1,66 @@
+/*
+** Boi, 2020
+** DMG / Serial.cpp
+*/
+
+#include "Serial.hpp"
+#include "Utils/Assertions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+Serial::Serial(Scheduler& scheduler, CPU& cpu, MMU& mmu)
+: m_scheduler(scheduler)
+, m_cpu(cpu)
+{
+	mmu.mapIO(0xFF01, this);
+	mmu.mapIO(0xFF02, this);
+
+	m_scheduler.setHandler(Event::SerialTransfer, [this](u64) { transferDone(); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+u8 Serial::readIO(u16 address)
+{
+	switch (address) {
+		case 0xFF01: return m_sb;
+		case 0xFF02: return m_sc | 0x7E;
+	}
+	ASSERT_NOT_REACHED();
+}
+
+void Serial::writeIO(u16 address, u8 value)
+{
+	switch (address) {
+		case 0xFF01:
+			m_sb = value;
+			break;
+		case 0xFF02:
+			m_sc = value & 0x81;
+			if ((m_sc & 0x81) == 0x81)
+				m_scheduler.schedule(Event::SerialTransfer, m_scheduler.now() + s_transfer_cycles);
+			else
+				m_scheduler.cancel(Event::SerialTransfer);
+			break;
+		default:
+			ASSERT_NOT_REACHED();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Serial::transferDone()
+{
+	m_sb = 0xFF;
+	m_sc &= ~0x80;
+	m_cpu.requestInterrupt(Interrupt::Serial);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,43 @@
+/*
+** Boi, 2020
+** DMG / Serial.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "CPU.hpp"
+#include "MMU.hpp"
+#include "Scheduler.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Link port with nothing plugged in: transfers clocked by the console shift
+// in 0xFF, externally clocked ones never complete.
+class Serial final : public IODevice
+{
+public:
+	Serial(Scheduler&, CPU&, MMU&);
+
+	u8 readIO(u16 address) override;
+	void writeIO(u16 address, u8 value) override;
+
+private:
+	void transferDone();
+
+	Scheduler& m_scheduler;
+	CPU& m_cpu;
+
+	u8 m_sb = 0x00;
+	u8 m_sc = 0x00;
+
+	// 8 bits at 8192 Hz
+	static constexpr u64 s_transfer_cycles = 4096;
+};
+
+}
@@ -0,0 +1,100 @@
+/*
+** Boi, 2020
+** DMG / SpriteIndex.cpp
+*/
+
+#include "SpriteIndex.hpp"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+SpriteIndex::SpriteIndex(MMU& mmu)
+: m_mmu(mmu)
+{
+	for (u8 i = 0; i < s_sprites; ++i)
+		m_priority[i] = i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpriteIndex::update(u8 height)
+{
+	// Every sprite covers other lines with the other size
+	bool resized = height != m_height;
+	const auto& dirty = m_mmu.dirtySprites(MMU::SpriteIndexConsumer);
+	if (!resized && dirty.none())
+		return;
+
+	const u8* oam = m_mmu.oam();
+	bool moved = false;
+	for (u8 i = 0; i < s_sprites; ++i) {
+		if (!resized && !dirty[i])
+			continue;
+
+		setLines(i, false);
+		m_y[i] = oam[i * 4];
+		moved |= m_x[i] != oam[i * 4 + 1];
+		m_x[i] = oam[i * 4 + 1];
+	}
+
+	m_height = height;
+	for (u8 i = 0; i < s_sprites; ++i) {
+		if (resized || dirty[i])
+			setLines(i, true);
+	}
+
+	if (moved)
+		sortByPriority();
+	m_mmu.clearDirtySprites(MMU::SpriteIndexConsumer);
+}
+
+void SpriteIndex::select(u8 ly, LineSprites& sprites) const
+{
+	// Drop the sprites past the first 10
+	u64 covering = m_lines[ly];
+	u64 selected = 0;
+	for (u8 count = 0; covering != 0 && count < LineSprites::s_max; ++count) {
+		selected |= covering & -covering;
+		covering &= covering - 1;
+	}
+
+	sprites.count = 0;
+	for (u8 i = 0; selected != 0; ++i) {
+		u8 sprite = m_priority[i];
+		if (selected & (1ull << sprite)) {
+			sprites.indices[sprites.count++] = sprite;
+			selected &= ~(1ull << sprite);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpriteIndex::setLines(u8 sprite, bool covered)
+{
+	// Lines above the screen wrap around past the last one
+	u8 top = m_y[sprite] - 16;
+	for (u8 y = 0; y < m_height; ++y) {
+		if (covered)
+			m_lines[static_cast<u8>(top + y)] |= 1ull << sprite;
+		else
+			m_lines[static_cast<u8>(top + y)] &= ~(1ull << sprite);
+	}
+}
+
+void SpriteIndex::sortByPriority()
+{
+	std::stable_sort(m_priority, m_priority + s_sprites, [this](u8 a, u8 b) {
+		return m_x[a] != m_x[b] ? m_x[a] < m_x[b] : a < b;
+	});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,53 @@
+/*
+** Boi, 2020
+** DMG / SpriteIndex.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MMU.hpp"
+#include "Renderer.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// The sprites covering each line, and all of them in drawing priority order,
+// kept up to date from the OAM entries the MMU flagged as written. Picking a
+// line's sprites doesn't need to go through the 40 entries.
+class SpriteIndex
+{
+public:
+	static constexpr u8 s_sprites = 40;
+
+public:
+	explicit SpriteIndex(MMU&);
+
+	// Takes the OAM writes since the last update into account
+	void update(u8 height);
+
+	// The first 10 sprites by OAM index covering the line, leftmost first,
+	// then lowest OAM index
+	void select(u8 ly, LineSprites&) const;
+
+private:
+	void setLines(u8 sprite, bool covered);
+	void sortByPriority();
+
+	MMU& m_mmu;
+
+	u8 m_height = 0;
+	// Where each sprite was when last updated
+	u8 m_y[s_sprites] {};
+	u8 m_x[s_sprites] {};
+
+	// One bit per OAM index
+	u64 m_lines[256] {};
+	u8 m_priority[s_sprites];
+};
+
+}
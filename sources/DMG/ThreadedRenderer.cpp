@@ -0,0 +1,160 @@
+/*
+** Boi, 2020
+** DMG / ThreadedRenderer.cpp
+*/
+
+#include "ThreadedRenderer.hpp"
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadedRenderer::ThreadedRenderer(MMU& mmu, const Factory& factory)
+: m_mmu(mmu)
+{
+	// Starts from a copy of video memory, later changes get queued
+	memcpy(m_video.vram(), m_mmu.vram(), VideoMemory::s_vram_size);
+	memcpy(m_video.oam(), m_mmu.oam(), VideoMemory::s_oam_size);
+	m_mmu.clearDirtyTiles();
+	m_mmu.clearDirtySprites(MMU::RenderThreadConsumer);
+
+	m_renderer = factory(m_video);
+	m_thread = std::thread(&ThreadedRenderer::renderLoop, this);
+}
+
+ThreadedRenderer::~ThreadedRenderer()
+{
+	push(Record::Stop, {}, 0);
+	m_queue.publish();
+	m_thread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ThreadedRenderer::beginLine(u8 ly, const LCDRegisters& registers, const LineSprites& sprites, u64 timestamp)
+{
+	pushMemoryChanges();
+
+	Record record;
+	record.kind = Record::BeginLine;
+	record.ly = ly;
+	m_ly = ly;
+	record.timestamp = timestamp;
+	record.registers = registers;
+	record.sprites = sprites;
+	m_queue.push(record);
+}
+
+void ThreadedRenderer::advance(const LCDRegisters& registers, u64 timestamp)
+{
+	push(Record::Advance, registers, timestamp);
+}
+
+void ThreadedRenderer::endLine(const LCDRegisters& registers, u64 timestamp)
+{
+	// OAM DMA may have run during the transfer
+	pushMemoryChanges();
+	push(Record::EndLine, registers, timestamp);
+
+	// Waking the render thread costs a system call, so it is only done once
+	// every few lines. The last visible line ends a batch.
+	if (m_ly % s_lines_per_batch == s_lines_per_batch - 1)
+		m_queue.publish();
+}
+
+void ThreadedRenderer::clear()
+{
+	push(Record::Clear, {}, 0);
+	m_queue.publish();
+}
+
+const u8* ThreadedRenderer::framebuffer()
+{
+	m_queue.waitUntilEmpty();
+	return m_renderer->framebuffer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ThreadedRenderer::push(Record::Kind kind, const LCDRegisters& registers, u64 timestamp)
+{
+	Record record;
+	record.kind = kind;
+	record.timestamp = timestamp;
+	record.registers = registers;
+	m_queue.push(record);
+}
+
+void ThreadedRenderer::pushMemoryChanges()
+{
+	Record record;
+	record.kind = Record::Memory;
+
+	// The dirty tile bits of the MMU are only read from here
+	const auto& dirty = m_mmu.dirtyTiles();
+	if (dirty.any()) {
+		for (u16 chunk = 0; chunk < dirty.size(); ++chunk) {
+			if (!dirty[chunk])
+				continue;
+			record.address = 0x8000 + chunk * 16;
+			memcpy(record.data, m_mmu.vram() + chunk * 16, sizeof(record.data));
+			m_queue.push(record);
+		}
+		m_mmu.clearDirtyTiles();
+	}
+
+	// Records hold 4 sprites each
+	const auto& sprites = m_mmu.dirtySprites(MMU::RenderThreadConsumer);
+	if (sprites.any()) {
+		for (u8 sprite = 0; sprite < sprites.size(); sprite += 4) {
+			if (!sprites[sprite] && !sprites[sprite + 1] && !sprites[sprite + 2] && !sprites[sprite + 3])
+				continue;
+			record.address = 0xFE00 + sprite * 4;
+			memcpy(record.data, m_mmu.oam() + sprite * 4, sizeof(record.data));
+			m_queue.push(record);
+		}
+		m_mmu.clearDirtySprites(MMU::RenderThreadConsumer);
+	}
+}
+
+void ThreadedRenderer::renderLoop()
+{
+	for (;;) {
+		const Record& record = m_queue.front();
+		switch (record.kind) {
+			case Record::BeginLine:
+				m_renderer->beginLine(record.ly, record.registers, record.sprites, record.timestamp);
+				break;
+			case Record::Advance:
+				m_renderer->advance(record.registers, record.timestamp);
+				break;
+			case Record::EndLine:
+				m_renderer->endLine(record.registers, record.timestamp);
+				break;
+			case Record::Clear:
+				m_renderer->clear();
+				break;
+			case Record::Memory:
+				if (record.address >= 0xFE00)
+					memcpy(m_video.oam() + (record.address - 0xFE00), record.data, sizeof(record.data));
+				else {
+					memcpy(m_video.vram() + (record.address - 0x8000), record.data, sizeof(record.data));
+					m_video.markDirty(record.address);
+				}
+				break;
+			case Record::Stop:
+				m_queue.pop();
+				return;
+		}
+		m_queue.pop();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,84 @@
+/*
+** Boi, 2020
+** DMG / ThreadedRenderer.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MMU.hpp"
+#include "Renderer.hpp"
+#include "VideoMemory.hpp"
+#include "Utils/SPSCQueue.hpp"
+#include "Utils/Types.hpp"
+
+#include <memory>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Runs another renderer on a thread of its own. Every call is queued as a
+// timestamped record along with the VRAM and OAM changes since the previous
+// one, which the render thread applies to its copy of video memory before
+// passing the call on. The inner renderer sees the same memory and
+// registers as it would on the emulation thread, so it draws the same
+// pixels. Records are handed over a few lines at a time.
+class ThreadedRenderer final : public Renderer
+{
+public:
+	ThreadedRenderer(MMU&, const Factory&);
+	~ThreadedRenderer() override;
+
+	void beginLine(u8 ly, const LCDRegisters&, const LineSprites&, u64 timestamp) override;
+	void advance(const LCDRegisters&, u64 timestamp) override;
+	void endLine(const LCDRegisters&, u64 timestamp) override;
+	void clear() override;
+
+	// Waits for the render thread to catch up
+	const u8* framebuffer() override;
+
+private:
+	struct Record
+	{
+		enum Kind : u8
+		{
+			BeginLine,
+			Advance,
+			EndLine,
+			Clear,
+			// 16 bytes of VRAM or OAM
+			Memory,
+			Stop,
+		};
+
+		Kind kind;
+		u8 ly;
+		u16 address;
+		u64 timestamp;
+		LCDRegisters registers;
+		LineSprites sprites;
+		u8 data[16];
+	};
+
+	static constexpr u8 s_lines_per_batch = 8;
+
+	void push(Record::Kind, const LCDRegisters&, u64 timestamp);
+	void pushMemoryChanges();
+	void renderLoop();
+
+	MMU& m_mmu;
+	u8 m_ly = 0;
+
+	// Owned by the render thread once started
+	VideoMemory m_video;
+	std::unique_ptr<Renderer> m_renderer;
+
+	SPSCQueue<Record, 0x1000> m_queue;
+	std::thread m_thread;
+};
+
+}
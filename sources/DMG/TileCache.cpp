@@ -0,0 +1,49 @@
+/*
+** Boi, 2020
+** DMG / TileCache.cpp
+*/
+
+#include "TileCache.hpp"
+#include "TileDecoder.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+TileCache::TileCache(VideoMemory& video)
+: m_video(video)
+{
+	for (u16 tile = 0; tile < s_tiles; ++tile)
+		decode(tile);
+	m_video.clearDirtyTiles(0, s_tiles - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TileCache::update()
+{
+	const auto& dirty = m_video.dirtyTiles();
+
+	// The bits past the tile data track the tile maps
+	static const auto s_tile_data = ~std::bitset<0x200>() >> (0x200 - s_tiles);
+	if ((dirty & s_tile_data).none())
+		return;
+
+	for (u16 tile = 0; tile < s_tiles; ++tile) {
+		if (dirty[tile])
+			decode(tile);
+	}
+	m_video.clearDirtyTiles(0, s_tiles - 1);
+}
+
+void TileCache::decode(u16 tile)
+{
+	TileDecoder::decodeTile(m_video.vram() + tile * 16, &m_pixels[tile][0][0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
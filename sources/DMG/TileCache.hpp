@@ -0,0 +1,41 @@
+/*
+** Boi, 2020
+** DMG / TileCache.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoMemory.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// The 384 tiles of VRAM decoded to one color index (0-3) per pixel. Tiles
+// only get decoded again once their bytes are flagged as written.
+class TileCache
+{
+public:
+	static constexpr u16 s_tiles = 384;
+
+public:
+	explicit TileCache(VideoMemory&);
+
+	// Decodes the tiles written to since the last update
+	void update();
+
+	// Tiles are numbered from 8000, 16 bytes each
+	const u8* row(u16 tile, u8 y) const { return m_pixels[tile][y]; }
+
+private:
+	void decode(u16 tile);
+
+	VideoMemory& m_video;
+	u8 m_pixels[s_tiles][8][8];
+};
+
+}
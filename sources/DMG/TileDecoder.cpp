@@ -0,0 +1,206 @@
+/*
+** Boi, 2020
+** DMG / TileDecoder.cpp
+*/
+
+#include "TileDecoder.hpp"
+#include "Utils/Assertions.hpp"
+
+#include <initializer_list>
+
+#if BOI_HAS_SIMD_TILES
+	#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void decodeTileScalar(const u8* data, u8* colors)
+{
+	// Each row is two bitplanes, low bits first, leftmost pixel in bit 7
+	for (u8 y = 0; y < 8; ++y) {
+		u8 low = data[y * 2];
+		u8 high = data[y * 2 + 1];
+		for (u8 x = 0; x < 8; ++x)
+			colors[y * 8 + x] = ((low >> (7 - x)) & 1) | (((high >> (7 - x)) & 1) << 1);
+	}
+}
+
+static void applyPaletteScalar(const u8* colors, u8 palette, u8* shades, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		shades[i] = (palette >> (colors[i] * 2)) & 0x03;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if BOI_HAS_SIMD_TILES
+
+static void decodeTileSSE2(const u8* data, u8* colors)
+{
+	const __m128i bits = _mm_set1_epi64x(0x0102040810204080);
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i two = _mm_set1_epi8(2);
+
+	// Split the planes, then spread every byte over the 8 pixels of its row
+	__m128i rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+	__m128i low = _mm_packus_epi16(_mm_and_si128(rows, _mm_set1_epi16(0x00FF)), _mm_setzero_si128());
+	__m128i high = _mm_packus_epi16(_mm_srli_epi16(rows, 8), _mm_setzero_si128());
+	low = _mm_unpacklo_epi8(low, low);
+	high = _mm_unpacklo_epi8(high, high);
+
+	__m128i low_words[2] = { _mm_unpacklo_epi16(low, low), _mm_unpackhi_epi16(low, low) };
+	__m128i high_words[2] = { _mm_unpacklo_epi16(high, high), _mm_unpackhi_epi16(high, high) };
+	for (int i = 0; i < 4; ++i) {
+		__m128i l = i & 1 ? _mm_unpackhi_epi32(low_words[i / 2], low_words[i / 2]) : _mm_unpacklo_epi32(low_words[i / 2], low_words[i / 2]);
+		__m128i h = i & 1 ? _mm_unpackhi_epi32(high_words[i / 2], high_words[i / 2]) : _mm_unpacklo_epi32(high_words[i / 2], high_words[i / 2]);
+		l = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(l, bits), bits), one);
+		h = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(h, bits), bits), two);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(colors + i * 16), _mm_or_si128(l, h));
+	}
+}
+
+static void applyPaletteSSE2(const u8* colors, u8 palette, u8* shades, size_t count)
+{
+	// No byte shuffle before SSSE3, select each color's shade with masks
+	__m128i shade[4];
+	for (int color = 0; color < 4; ++color)
+		shade[color] = _mm_set1_epi8((palette >> (color * 2)) & 0x03);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + i));
+		__m128i result = _mm_and_si128(_mm_cmpeq_epi8(c, _mm_setzero_si128()), shade[0]);
+		for (int color = 1; color < 4; ++color)
+			result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(color)), shade[color]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(shades + i), result);
+	}
+	applyPaletteScalar(colors + i, palette, shades + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void decodeTileAVX2(const u8* data, u8* colors)
+{
+	// Byte shuffles stay within 128 bit lanes, both lanes hold the whole tile
+	const __m256i tile = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+	const __m256i bits = _mm256_set1_epi64x(0x0102040810204080);
+	const __m256i one = _mm256_set1_epi8(1);
+	const __m256i two = _mm256_set1_epi8(2);
+
+	for (int i = 0; i < 2; ++i) {
+		// Rows 4i to 4i+3, one per 8 bytes
+		const char r = i * 8;
+		__m256i low = _mm256_shuffle_epi8(tile, _mm256_setr_epi8(
+			r + 0, r + 0, r + 0, r + 0, r + 0, r + 0, r + 0, r + 0, r + 2, r + 2, r + 2, r + 2, r + 2, r + 2, r + 2, r + 2,
+			r + 4, r + 4, r + 4, r + 4, r + 4, r + 4, r + 4, r + 4, r + 6, r + 6, r + 6, r + 6, r + 6, r + 6, r + 6, r + 6
+		));
+		__m256i high = _mm256_shuffle_epi8(tile, _mm256_setr_epi8(
+			r + 1, r + 1, r + 1, r + 1, r + 1, r + 1, r + 1, r + 1, r + 3, r + 3, r + 3, r + 3, r + 3, r + 3, r + 3, r + 3,
+			r + 5, r + 5, r + 5, r + 5, r + 5, r + 5, r + 5, r + 5, r + 7, r + 7, r + 7, r + 7, r + 7, r + 7, r + 7, r + 7
+		));
+		low = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(low, bits), bits), one);
+		high = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(high, bits), bits), two);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors + i * 32), _mm256_or_si256(low, high));
+	}
+}
+
+__attribute__((target("avx2")))
+static void applyPaletteAVX2(const u8* colors, u8 palette, u8* shades, size_t count)
+{
+	// The palette as a 4 entry lookup table indexed by color
+	const __m256i table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+		palette & 0x03, (palette >> 2) & 0x03, (palette >> 4) & 0x03, (palette >> 6) & 0x03,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+	));
+
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		__m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(shades + i), _mm256_shuffle_epi8(table, c));
+	}
+	// Not through the SSE2 kernel: mixing in legacy SSE code with the upper
+	// halves of the registers dirty stalls
+	applyPaletteScalar(colors + i, palette, shades + i, count - i);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+TileDecoder::Kernel TileDecoder::s_kernel = TileDecoder::Kernel::Scalar;
+void (*TileDecoder::s_decode_tile)(const u8*, u8*) = decodeTileScalar;
+void (*TileDecoder::s_apply_palette)(const u8*, u8, u8*, size_t) = applyPaletteScalar;
+
+// Switches to the best kernel before main()
+static const bool s_selected = [] {
+	TileDecoder::use(TileDecoder::best());
+	return true;
+}();
+
+bool TileDecoder::supported(Kernel kernel)
+{
+	switch (kernel) {
+		case Kernel::Scalar:
+			return true;
+#if BOI_HAS_SIMD_TILES
+		case Kernel::SSE2:
+			return true;
+		case Kernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+		default:
+			return false;
+	}
+}
+
+TileDecoder::Kernel TileDecoder::best()
+{
+	for (Kernel kernel : { Kernel::AVX2, Kernel::SSE2 }) {
+		if (supported(kernel))
+			return kernel;
+	}
+	return Kernel::Scalar;
+}
+
+const char* TileDecoder::name(Kernel kernel)
+{
+	switch (kernel) {
+		case Kernel::Scalar: return "scalar";
+		case Kernel::SSE2: return "sse2";
+		case Kernel::AVX2: return "avx2";
+	}
+	return "?";
+}
+
+void TileDecoder::use(Kernel kernel)
+{
+	ASSERT_MSG(supported(kernel), "Tile decoder kernel %s not supported", name(kernel));
+
+	s_kernel = kernel;
+	switch (kernel) {
+		case Kernel::Scalar:
+			s_decode_tile = decodeTileScalar;
+			s_apply_palette = applyPaletteScalar;
+			break;
+#if BOI_HAS_SIMD_TILES
+		case Kernel::SSE2:
+			s_decode_tile = decodeTileSSE2;
+			s_apply_palette = applyPaletteSSE2;
+			break;
+		case Kernel::AVX2:
+			s_decode_tile = decodeTileAVX2;
+			s_apply_palette = applyPaletteAVX2;
+			break;
+#endif
+		default:
+			break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
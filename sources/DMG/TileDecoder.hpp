@@ -0,0 +1,59 @@
+/*
+** Boi, 2020
+** DMG / TileDecoder.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/Types.hpp"
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The vector kernels only use compiler intrinsics, AVX2 is detected at runtime.
+#if defined(__x86_64__)
+	#define BOI_HAS_SIMD_TILES 1
+#else
+	#define BOI_HAS_SIMD_TILES 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// Pixel conversion kernels: 2bpp tile data to color indices, and color
+// indices to shades through a palette register. Every kernel produces the
+// same output, the fastest one the CPU supports is picked on startup.
+class TileDecoder
+{
+public:
+	enum class Kernel : u8
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+	};
+
+	static bool supported(Kernel);
+	static Kernel best();
+	static const char* name(Kernel);
+
+	static Kernel kernel() { return s_kernel; }
+	static void use(Kernel);
+
+	// Decodes the 8 rows of a tile, 16 bytes, to 64 color indices
+	static void decodeTile(const u8* data, u8* colors) { s_decode_tile(data, colors); }
+	// Maps color indices (0-3) to shades with BGP, OBP0 or OBP1
+	static void applyPalette(const u8* colors, u8 palette, u8* shades, size_t count) { s_apply_palette(colors, palette, shades, count); }
+
+private:
+	static Kernel s_kernel;
+	static void (*s_decode_tile)(const u8*, u8*);
+	static void (*s_apply_palette)(const u8*, u8, u8*, size_t);
+};
+
+}
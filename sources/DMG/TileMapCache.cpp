@@ -0,0 +1,69 @@
+/*
+** Boi, 2020
+** DMG / TileMapCache.cpp
+*/
+
+#include "TileMapCache.hpp"
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Dirty tile bits covering the maps, 16 entries each
+static constexpr u16 s_first_map_bit = TileCache::s_tiles;
+
+TileMapCache::TileMapCache(VideoMemory& video, const TileCache& tiles)
+: m_video(video)
+, m_tiles(tiles)
+{
+	for (Layer& layer : m_layers)
+		layer.pending.set();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TileMapCache::update()
+{
+	const auto& dirty = m_video.dirtyTiles();
+	if (dirty.none())
+		return;
+
+	for (Layer& layer : m_layers)
+		layer.pending |= dirty;
+	m_video.clearDirtyTiles(s_first_map_bit, dirty.size() - 1);
+}
+
+const u8* TileMapCache::row(bool high_map, bool unsigned_tiles, u8 y)
+{
+	Layer& layer = m_layers[high_map * 2 + unsigned_tiles];
+	if (layer.pending.any())
+		redraw(layer, high_map, unsigned_tiles);
+	return layer.pixels[y];
+}
+
+void TileMapCache::redraw(Layer& layer, bool high_map, bool unsigned_tiles)
+{
+	const u16 map_offset = high_map ? 0x1C00 : 0x1800;
+	const u8* map = m_video.vram() + map_offset;
+
+	for (u16 entry = 0; entry < 32 * 32; ++entry) {
+		// Tile data is addressed from 8000, or signed from 9000
+		u16 tile = unsigned_tiles ? map[entry] : 256 + static_cast<i8>(map[entry]);
+		if (!layer.pending[(map_offset + entry) >> 4] && !layer.pending[tile])
+			continue;
+
+		u8 (*block)[s_size] = &layer.pixels[(entry / 32) * 8];
+		for (u8 y = 0; y < 8; ++y)
+			memcpy(&block[y][(entry % 32) * 8], m_tiles.row(tile, y), 8);
+	}
+	layer.pending.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
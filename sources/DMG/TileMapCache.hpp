@@ -0,0 +1,55 @@
+/*
+** Boi, 2020
+** DMG / TileMapCache.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoMemory.hpp"
+#include "TileCache.hpp"
+#include "Utils/Types.hpp"
+
+#include <bitset>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// The two 256x256 tile maps drawn to color indices, for both tile data
+// addressing modes. A layer only redraws the tiles of its map whose map
+// entry or tile data was written to, when it is next used.
+class TileMapCache
+{
+public:
+	static constexpr u16 s_size = 256;
+
+public:
+	TileMapCache(VideoMemory&, const TileCache&);
+
+	// Collects the VRAM writes since the last update, it must run before the
+	// tile cache's update clears them
+	void update();
+
+	// A row of the map at 9C00 or 9800, with tile data from 8000 or 8800
+	const u8* row(bool high_map, bool unsigned_tiles, u8 y);
+
+private:
+	struct Layer
+	{
+		u8 pixels[s_size][s_size];
+		// Same bits as the dirty tiles of video memory, not yet drawn
+		std::bitset<0x200> pending;
+	};
+
+	void redraw(Layer&, bool high_map, bool unsigned_tiles);
+
+	VideoMemory& m_video;
+	const TileCache& m_tiles;
+
+	Layer m_layers[4];
+};
+
+}
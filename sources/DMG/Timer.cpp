@@ -0,0 +1,93 @@
+/*
+** Boi, 2020
+** DMG / Timer.cpp
+*/
+
+#include "Timer.hpp"
+#include "Utils/Assertions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+Timer::Timer(Scheduler& scheduler, CPU& cpu, MMU& mmu)
+: m_scheduler(scheduler)
+, m_cpu(cpu)
+{
+	for (u16 address = 0xFF04; address <= 0xFF07; ++address)
+		mmu.mapIO(address, this);
+
+	m_scheduler.setHandler(Event::TimerOverflow, [this](u64 timestamp) { overflow(timestamp); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+u8 Timer::readIO(u16 address)
+{
+	const u64 now = m_scheduler.now();
+
+	switch (address) {
+		case 0xFF04: return ((now - m_div_epoch) >> 8) & 0xFF;
+		case 0xFF05: sync(now); return m_tima;
+		case 0xFF06: return m_tma;
+		case 0xFF07: return m_tac | 0xF8;
+	}
+	ASSERT_NOT_REACHED();
+}
+
+void Timer::writeIO(u16 address, u8 value)
+{
+	const u64 now = m_scheduler.now();
+	sync(now);
+
+	switch (address) {
+		case 0xFF04: m_div_epoch = now; break;
+		case 0xFF05: m_tima = value; break;
+		case 0xFF06: m_tma = value; break;
+		case 0xFF07: m_tac = value & 0x07; break;
+		default: ASSERT_NOT_REACHED();
+	}
+
+	scheduleOverflow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+u64 Timer::period() const
+{
+	static constexpr u64 periods[] = { 1024, 16, 64, 256 };
+	return periods[m_tac & 0x03];
+}
+
+void Timer::sync(u64 now)
+{
+	if (enabled())
+		m_tima += ticksAt(now) - ticksAt(m_sync);
+	m_sync = now;
+}
+
+void Timer::scheduleOverflow()
+{
+	if (!enabled()) {
+		m_scheduler.cancel(Event::TimerOverflow);
+		return;
+	}
+
+	u64 overflow_tick = ticksAt(m_sync) + (0x100 - m_tima);
+	m_scheduler.schedule(Event::TimerOverflow, m_div_epoch + overflow_tick * period());
+}
+
+void Timer::overflow(u64 timestamp)
+{
+	m_sync = timestamp;
+	m_tima = m_tma;
+	m_cpu.requestInterrupt(Interrupt::Timer);
+	scheduleOverflow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,53 @@
+/*
+** Boi, 2020
+** DMG / Timer.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "CPU.hpp"
+#include "MMU.hpp"
+#include "Scheduler.hpp"
+#include "Utils/Types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// DIV and TIMA are never ticked: their values are derived from the cycle
+// counter when read, and TIMA overflows are scheduled ahead of time.
+class Timer final : public IODevice
+{
+public:
+	Timer(Scheduler&, CPU&, MMU&);
+
+	u8 readIO(u16 address) override;
+	void writeIO(u16 address, u8 value) override;
+
+private:
+	bool enabled() const { return m_tac & 0x04; }
+	u64 period() const;
+	// Number of TIMA increments that happen up to the given time
+	u64 ticksAt(u64 timestamp) const { return (timestamp - m_div_epoch) / period(); }
+
+	void sync(u64 now);
+	void scheduleOverflow();
+	void overflow(u64 timestamp);
+
+	Scheduler& m_scheduler;
+	CPU& m_cpu;
+
+	// Time at which the divider was last reset
+	u64 m_div_epoch = 0;
+	// Time up to which m_tima is up to date
+	u64 m_sync = 0;
+
+	u8 m_tima = 0x00;
+	u8 m_tma = 0x00;
+	u8 m_tac = 0xF8;
+};
+
+}
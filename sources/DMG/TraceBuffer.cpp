@@ -0,0 +1,75 @@
+/*
+** Boi, 2020
+** DMG / TraceBuffer.cpp
+*/
+
+#include "TraceBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+////////////////////////////////////////////////////////////////////////////////
+
+TraceBuffer::TraceBuffer(size_t capacity_log2)
+: m_records(new TraceRecord[size_t(1) << capacity_log2])
+, m_mask((size_t(1) << capacity_log2) - 1)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TraceBuffer::size() const
+{
+	return std::min<u64>(m_head.load(std::memory_order_acquire), capacity());
+}
+
+static bool writeAll(int fd, const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t written = ::write(fd, bytes, size);
+		if (written <= 0)
+			return false;
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+
+bool TraceBuffer::dump(const char* filename) const
+{
+	const u64 head = m_head.load(std::memory_order_acquire);
+	const u64 count = std::min<u64>(head, capacity());
+	const u64 oldest = head - count;
+
+	TraceFileHeader header;
+	memcpy(header.magic, s_magic, sizeof(s_magic));
+	header.version = s_version;
+	header.record_size = sizeof(TraceRecord);
+	header.record_count = count;
+
+	int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	// The ring wraps at most once between the oldest and latest records
+	size_t first = oldest & m_mask;
+	size_t first_count = std::min<u64>(count, capacity() - first);
+	bool ok = writeAll(fd, &header, sizeof(header))
+		&& writeAll(fd, &m_records[first], first_count * sizeof(TraceRecord))
+		&& writeAll(fd, &m_records[0], (count - first_count) * sizeof(TraceRecord));
+
+	::close(fd);
+	return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,83 @@
+/*
+** Boi, 2020
+** DMG / TraceBuffer.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/Types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+struct TraceRecord
+{
+	enum Kind : u8
+	{
+		Instruction,
+		Read,
+		Write,
+	};
+
+	// Instructions carry the state before they run, memory accesses only
+	// their address and value
+	u64 cycles;
+	u16 pc;
+	u16 sp;
+	u8 a, f, b, c, d, e, h, l;
+	u8 pcmem[4];
+	u16 address;
+	u8 value;
+	Kind kind;
+	u8 reserved[4];
+};
+
+static_assert(sizeof(TraceRecord) == 32);
+
+struct TraceFileHeader
+{
+	char magic[8];
+	u32 version;
+	u32 record_size;
+	u64 record_count;
+};
+
+// Keeps the latest records in a power of two sized ring. Only the emulation
+// thread pushes, dump() may run from a signal handler.
+class TraceBuffer
+{
+public:
+	static constexpr char s_magic[8] = { 'B', 'O', 'I', 'T', 'R', 'A', 'C', 'E' };
+	static constexpr u32 s_version = 1;
+
+public:
+	explicit TraceBuffer(size_t capacity_log2 = 21);
+
+	void push(const TraceRecord& record)
+	{
+		u64 head = m_head.load(std::memory_order_relaxed);
+		m_records[head & m_mask] = record;
+		m_head.store(head + 1, std::memory_order_release);
+	}
+
+	size_t capacity() const { return m_mask + 1; }
+	size_t size() const;
+
+	// Writes the records, oldest first. Async-signal-safe.
+	bool dump(const char* filename) const;
+
+private:
+	std::unique_ptr<TraceRecord[]> m_records;
+	size_t m_mask;
+	std::atomic<u64> m_head = 0;
+};
+
+}
@@ -0,0 +1,50 @@
+/*
+** Boi, 2020
+** DMG / VideoMemory.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/Types.hpp"
+
+#include <bitset>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DMG
+{
+
+// VRAM and OAM as the renderers read them, with the VRAM writes they have yet
+// to pick up flagged per 16 bytes: one tile, or 16 tile map entries.
+class VideoMemory
+{
+public:
+	static constexpr size_t s_vram_size = 0x2000;
+	static constexpr size_t s_oam_size = 0xA0;
+
+public:
+	u8* vram() { return m_vram; }
+	const u8* vram() const { return m_vram; }
+	u8* oam() { return m_oam; }
+	const u8* oam() const { return m_oam; }
+
+	const std::bitset<0x200>& dirtyTiles() const { return m_dirty_tiles; }
+	// Addresses from 8000
+	void markDirty(u16 address) { m_dirty_tiles.set((address - 0x8000) >> 4); }
+	void clearDirtyTiles() { m_dirty_tiles.reset(); }
+	void clearDirtyTiles(u16 first, u16 last)
+	{
+		for (u16 tile = first; tile <= last; ++tile)
+			m_dirty_tiles.reset(tile);
+	}
+
+private:
+	u8 m_vram[s_vram_size] {};
+	u8 m_oam[s_oam_size] {};
+	std::bitset<0x200> m_dirty_tiles;
+};
+
+}
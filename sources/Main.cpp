@@ -7,29 +7,176 @@
 #include "Utils/MappedFile.hpp"
 #include "Utils/OptionParser.hpp"
 
+#include <filesystem>
+#include <sstream>
+
+#include <signal.h>
 #include <stdlib.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static const DMG::TraceBuffer* s_trace_buffer = nullptr;
+static std::string s_trace_filename;
+
+// Dumps the trace when an assertion aborts, or on SIGUSR1
+static void dumpTrace(int signal)
+{
+	if (s_trace_buffer)
+		s_trace_buffer->dump(s_trace_filename.c_str());
+
+	if (signal == SIGABRT) {
+		::signal(SIGABRT, SIG_DFL);
+		::raise(SIGABRT);
+	}
+}
+
+// Parses a comma-separated list of hexadecimal addresses or BEGIN-END
+// ranges, each optionally followed by a :SUFFIX
+static bool parseRanges(const std::string& list, const std::function<bool(u16, u16, const std::string&)>& accept)
+{
+	std::istringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		std::string suffix;
+		if (size_t colon = item.find(':'); colon != std::string::npos) {
+			suffix = item.substr(colon + 1);
+			item.resize(colon);
+		}
+
+		unsigned begin, end;
+		int length = 0;
+		if (sscanf(item.c_str(), "%x-%x%n", &begin, &end, &length) != 2 || (size_t)length != item.size()) {
+			if (sscanf(item.c_str(), "%x%n", &begin, &length) != 1 || (size_t)length != item.size())
+				return false;
+			end = begin;
+		}
+		if (begin > end || end > 0xFFFF || !accept(begin, end, suffix))
+			return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 int main(int argc, char **argv)
 {
 	std::string rom_filename;
+	std::string interpreter_name = "table";
+	std::string ppu_name = "scanline";
+	bool render_thread = false;
+	int profile_frames = 0;
+	int trace_size = 21;
+	std::string breakpoints;
+	std::string watchpoints;
 
 	OptionParser opt;
 	opt.addArgument(rom_filename, "Filename of the ROM to play", "ROM");
+	opt.addOption(interpreter_name, 'i', "interpreter", "CPU interpreter: table, threaded, blocks or jit", "NAME");
+	opt.addOption(ppu_name, 0, "ppu", "PPU engine: scanline, or fifo for games changing registers mid-line", "NAME");
+	opt.addOption(render_thread, 0, "render-thread", "Draw the screen on a second thread");
+	opt.addOption(profile_frames, 'p', "profile", "Run FRAMES frames on the table interpreter and print the most frequent opcode sequences. Every run profiles its first instructions the same way to pick its superinstructions", "FRAMES");
+	opt.addOption(s_trace_filename, 't', "trace", "Record the latest instructions, written to FILE on assertion failure or SIGUSR1", "FILE");
+	opt.addOption(trace_size, 0, "trace-size", "Keep the latest 2^LOG2 trace records (default 21)", "LOG2");
+	opt.addOption(breakpoints, 'b', "break", "Stop before running code in RANGES, e.g. 0150,C000-C0FF", "RANGES");
+	opt.addOption(watchpoints, 'w', "watch", "Stop after accessing memory in RANGES, suffixed by :r, :w or :rw (default), e.g. FF80-FFFE:w", "RANGES");
 	if (!opt.parse(argc, argv))
 		return EXIT_FAILURE;
 
-	MappedFile rom_file(rom_filename);
-	if (!rom_file.isMapped()) {
+	DMG::Core::Interpreter interpreter;
+	if (interpreter_name == "table")
+		interpreter = DMG::Core::Interpreter::Table;
+#if BOI_HAS_THREADED_INTERPRETER
+	else if (interpreter_name == "threaded")
+		interpreter = DMG::Core::Interpreter::Threaded;
+#endif
+	else if (interpreter_name == "blocks")
+		interpreter = DMG::Core::Interpreter::Blocks;
+#if BOI_HAS_JIT
+	else if (interpreter_name == "jit")
+		interpreter = DMG::Core::Interpreter::Recompiler;
+#endif
+	else {
+		std::cerr << "Unknown interpreter \"" << interpreter_name << '"' << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	DMG::PPU::Engine ppu_engine;
+	if (ppu_name == "scanline")
+		ppu_engine = DMG::PPU::Engine::Scanline;
+	else if (ppu_name == "fifo")
+		ppu_engine = DMG::PPU::Engine::PixelFIFO;
+	else {
+		std::cerr << "Unknown PPU engine \"" << ppu_name << '"' << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	auto rom_file = std::make_shared<const MappedFile>(rom_filename);
+	if (!rom_file->isMapped()) {
 		std::cerr << "Unable to map contents of file \"" << rom_filename << '"' << std::endl;
 		return EXIT_FAILURE;
 	}
 
-	std::cout << "ROM size: " << rom_file.size() << std::endl;
+	std::cout << "ROM size: " << rom_file->size() << std::endl;
+
+	if (profile_frames > 0) {
+		DMG::Core core(rom_file, DMG::Core::Interpreter::Table);
+		core.cpu().enableProfiling();
+		core.runFor((u64)profile_frames * DMG::Core::s_cycles_per_frame);
+		core.cpu().profile()->print(std::cout, 16);
+		return EXIT_SUCCESS;
+	}
+
+	DMG::Core core(rom_file, interpreter, ppu_engine);
+	if (render_thread)
+		core.ppu().enableRenderThread();
+
+	if (core.mmu().cartridge().hasBattery()) {
+		std::string save_filename = std::filesystem::path(rom_filename).replace_extension(".sav");
+		if (!core.attachSave(save_filename))
+			std::cerr << "Unable to map save file \"" << save_filename << "\", progress will be lost" << std::endl;
+	}
+
+	if (!s_trace_filename.empty()) {
+		core.enableTraceBuffer(trace_size);
+		s_trace_buffer = core.traceBuffer();
+		::signal(SIGABRT, dumpTrace);
+		::signal(SIGUSR1, dumpTrace);
+	}
+
+	bool valid_breakpoints = parseRanges(breakpoints, [&](u16 begin, u16 end, const std::string& suffix) {
+		if (!suffix.empty())
+			return false;
+		core.addBreakpoint(begin, end);
+		return true;
+	});
+	if (!valid_breakpoints) {
+		std::cerr << "Invalid breakpoints \"" << breakpoints << '"' << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	bool valid_watchpoints = parseRanges(watchpoints, [&](u16 begin, u16 end, const std::string& suffix) {
+		u8 access = 0;
+		if (suffix.empty() || suffix == "rw")
+			access = DMG::MMU::WatchRead | DMG::MMU::WatchWrite;
+		else if (suffix == "r")
+			access = DMG::MMU::WatchRead;
+		else if (suffix == "w")
+			access = DMG::MMU::WatchWrite;
+		else
+			return false;
+		core.addWatchpoint(begin, end, access);
+		return true;
+	});
+	if (!valid_watchpoints) {
+		std::cerr << "Invalid watchpoints \"" << watchpoints << '"' << std::endl;
+		return EXIT_FAILURE;
+	}
 
-	DMG::Core core(std::move(rom_file));
 	core.run();
 
+	// Keep the history leading to the hit
+	if (core.stopped() && s_trace_buffer)
+		s_trace_buffer->dump(s_trace_filename.c_str());
+
 	return EXIT_SUCCESS;
 }
\ No newline at end of file
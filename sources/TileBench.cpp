@@ -0,0 +1,114 @@
+/*
+** Boi, 2020
+** Tile decoder benchmark entry point
+*/
+
+#include "DMG/TileDecoder.hpp"
+#include "Utils/OptionParser.hpp"
+#include "Utils/TermColors.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using DMG::TileDecoder;
+
+// Every low/high byte pair, 8 rows per tile
+static std::vector<u8> allRows()
+{
+	std::vector<u8> data(0x10000 * 2);
+	for (u32 row = 0; row < 0x10000; ++row) {
+		data[row * 2] = row & 0xFF;
+		data[row * 2 + 1] = row >> 8;
+	}
+	return data;
+}
+
+static std::vector<u8> decodeAll(const std::vector<u8>& data)
+{
+	std::vector<u8> colors(data.size() / 2 * 8);
+	for (size_t tile = 0; tile < data.size() / 16; ++tile)
+		TileDecoder::decodeTile(&data[tile * 16], &colors[tile * 64]);
+	return colors;
+}
+
+static std::vector<u8> paletteAll(const std::vector<u8>& colors)
+{
+	std::vector<u8> shades(colors.size() * 0x100);
+	for (u32 palette = 0; palette < 0x100; ++palette)
+		TileDecoder::applyPalette(colors.data(), palette, &shades[palette * colors.size()], colors.size());
+	return shades;
+}
+
+template<typename F>
+static double nanosecondsPer(u64 count, F&& f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	int iterations = 200000;
+
+	OptionParser opt;
+	opt.addOption(iterations, 'n', "iterations", "Tiles and lines converted per kernel", "COUNT");
+	if (!opt.parse(argc, argv))
+		return EXIT_FAILURE;
+
+	const std::vector<u8> rows = allRows();
+	// A line of 160 pixels cycling through the colors, plus an odd tail
+	std::vector<u8> line(163);
+	for (size_t x = 0; x < line.size(); ++x)
+		line[x] = (x * 7 + x / 5) & 0x03;
+
+	TileDecoder::use(TileDecoder::Kernel::Scalar);
+	const std::vector<u8> expected_colors = decodeAll(rows);
+	const std::vector<u8> expected_shades = paletteAll(line);
+
+	bool matching = true;
+	for (auto kernel : { TileDecoder::Kernel::Scalar, TileDecoder::Kernel::SSE2, TileDecoder::Kernel::AVX2 }) {
+		if (!TileDecoder::supported(kernel)) {
+			printf(FAINT "%-8s unsupported" RESET "\n", TileDecoder::name(kernel));
+			continue;
+		}
+		TileDecoder::use(kernel);
+
+		bool exact = decodeAll(rows) == expected_colors && paletteAll(line) == expected_shades;
+		matching &= exact;
+
+		u8 tile[16];
+		u8 colors[64];
+		u8 shades[160];
+		double tile_ns = nanosecondsPer(iterations, [&] {
+			for (int i = 0; i < iterations; ++i) {
+				memcpy(tile, &rows[(i & 0xFFF) * 16], sizeof(tile));
+				TileDecoder::decodeTile(tile, colors);
+				asm volatile("" : : "r"(colors) : "memory");
+			}
+		});
+		double line_ns = nanosecondsPer(iterations, [&] {
+			for (int i = 0; i < iterations; ++i) {
+				TileDecoder::applyPalette(line.data(), i, shades, sizeof(shades));
+				asm volatile("" : : "r"(shades) : "memory");
+			}
+		});
+
+		printf(
+			"%-8s %s  " CYAN "%6.2f" RESET " ns/tile  " CYAN "%6.2f" RESET " ns/line\n",
+			TileDecoder::name(kernel), exact ? GREEN "exact" RESET : RED "MISMATCH" RESET, tile_ns, line_ns
+		);
+	}
+
+	TileDecoder::use(TileDecoder::best());
+	return matching ? EXIT_SUCCESS : EXIT_FAILURE;
+}
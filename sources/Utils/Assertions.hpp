@@ -10,6 +10,7 @@
 #include "TermColors.hpp"
 
 #include <cstdio>
+#include <cstdlib>
 
 ////////////////////////////////////////////////////////////////////////////////
 
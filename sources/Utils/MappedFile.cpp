@@ -31,6 +31,33 @@ MappedFile::MappedFile(const std::string& filename)
 	::close(fd);
 }
 
+MappedFile::MappedFile(const std::string& filename, size_t size)
+{
+	int fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		perror("open");
+		return;
+	}
+
+	struct stat st;
+	::fstat(fd, &st);
+	if ((size_t)st.st_size < size && ::ftruncate(fd, size) < 0) {
+		perror("ftruncate");
+		::close(fd);
+		return;
+	}
+
+	// Populated upfront so that writes never fault on the disk
+	m_size = size;
+	m_map = ::mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+	if (m_map == MAP_FAILED)
+		perror("mmap");
+	else
+		m_mapped = true;
+
+	::close(fd);
+}
+
 MappedFile::~MappedFile()
 {
 	unmap();
@@ -50,4 +77,16 @@ void MappedFile::unmap()
 	m_size = 0;
 	m_map = nullptr;
 	m_mapped = false;
+}
+
+bool MappedFile::sync()
+{
+	if (!isMapped())
+		return false;
+
+	if (::msync(m_map, m_size, MS_SYNC) < 0) {
+		perror("msync");
+		return false;
+	}
+	return true;
 }
\ No newline at end of file
@@ -15,9 +15,13 @@ class MappedFile
 {
 public:
 	explicit MappedFile(const std::string& filename);
+	// Maps the file for writing, creating it or extending it to `size` bytes
+	MappedFile(const std::string& filename, size_t size);
 	~MappedFile();
 
 	void unmap();
+	// Blocks until written changes reach the disk
+	bool sync();
 
 	void* data() { return m_map; }
 	const void* data() const { return m_map; }
@@ -0,0 +1,79 @@
+/*
+** Boi, 2020
+** SPSCQueue.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Lock-free ring buffer between one producer thread and one consumer thread.
+// Either side only sleeps when the queue is full or empty, respectively. A
+// sleeping consumer is only woken by publish(), so that items can be handed
+// over in batches, while a producer waiting for room is woken as soon as an
+// item is popped.
+template<typename T, size_t Capacity>
+class SPSCQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	// Producer side, waits for room when full
+	void push(const T& item)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		for (size_t head = m_head.load(std::memory_order_acquire); tail - head == Capacity; head = m_head.load(std::memory_order_acquire)) {
+			publish();
+			m_head.wait(head, std::memory_order_acquire);
+		}
+
+		m_items[tail & (Capacity - 1)] = item;
+		m_tail.store(tail + 1, std::memory_order_release);
+	}
+
+	// Producer side, wakes the consumer up for the items pushed so far
+	void publish() { m_tail.notify_one(); }
+
+	// Producer side, returns once the consumer popped every item
+	void waitUntilEmpty()
+	{
+		publish();
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		for (size_t head = m_head.load(std::memory_order_acquire); head != tail; head = m_head.load(std::memory_order_acquire))
+			m_head.wait(head, std::memory_order_acquire);
+	}
+
+	// Consumer side, waits for an item when empty. The item stays queued
+	// until popped, so that the producer sees it as pending while in use.
+	const T& front()
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if (m_tail.load(std::memory_order_acquire) == head) {
+			// Wake a producer waiting for the queue to drain or make room
+			m_head.notify_one();
+			m_tail.wait(head, std::memory_order_acquire);
+		}
+		return m_items[head & (Capacity - 1)];
+	}
+
+	void pop()
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		m_head.store(head + 1, std::memory_order_release);
+
+		// Wake a producer waiting for room
+		if (m_tail.load(std::memory_order_acquire) - head == Capacity)
+			m_head.notify_one();
+	}
+
+private:
+	alignas(64) std::atomic<size_t> m_head = 0;
+	alignas(64) std::atomic<size_t> m_tail = 0;
+	std::array<T, Capacity> m_items;
+};
@@ -0,0 +1,31 @@
+/*
+** Boi, 2020
+** Utils / Trace.hpp
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Mask of the trace categories compiled in, set by the BOI_TRACE CMake
+// option. Disabled categories leave no code behind.
+#ifndef BOI_TRACE
+	#define BOI_TRACE 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Trace
+{
+
+enum Category : unsigned
+{
+	Opcodes   = 1 << 0,
+	Memory    = 1 << 1,
+	Registers = 1 << 2,
+};
+
+template<Category C>
+inline constexpr bool enabled = (BOI_TRACE & C) != 0;
+
+}